@@ -855,7 +855,25 @@ LUA_API int lua_load (lua_State *L, lua_Reader reader, void *data,
   lua_lock(L);
   if (!chunkname) chunkname = "?";
   luaZ_init(L, &z, reader, data);
-  status = luaD_protectedparser(L, &z, chunkname);
+  status = luaD_protectedparser(L, &z, chunkname, 0);
+  lua_unlock(L);
+  return status;
+}
+
+
+/*
+** Like lua_load, but only accepts a precompiled chunk. Bytecode is
+** otherwise refused, so this is reserved for chunks the engine compiled
+** and cached itself.
+*/
+LUA_API int lua_loadbytecode (lua_State *L, lua_Reader reader, void *data,
+                              const char *chunkname) {
+  ZIO z;
+  int status;
+  lua_lock(L);
+  if (!chunkname) chunkname = "?";
+  luaZ_init(L, &z, reader, data);
+  status = luaD_protectedparser(L, &z, chunkname, 1);
   lua_unlock(L);
   return status;
 }
@@ -77,6 +77,8 @@ LUALIB_API int (luaL_loadfile) (lua_State *L, const char *filename);
 LUALIB_API int (luaL_loadbuffer) (lua_State *L, const char *buff, size_t sz,
                                   const char *name);
 LUALIB_API int (luaL_loadstring) (lua_State *L, const char *s);
+LUALIB_API int (luaL_loadbytecode) (lua_State *L, const char *buff, size_t sz,
+                                    const char *name);
 
 LUALIB_API lua_State *(luaL_newstate) (void);
 
@@ -498,6 +498,7 @@ struct SParser {  /* data to `f_parser' */
   ZIO *z;
   Mbuffer buff;  /* buffer to be used by the scanner */
   const char *name;
+  int bytecode;  /* only accept a precompiled chunk */
 };
 
 static void f_parser (lua_State *L, void *ud) {
@@ -511,9 +512,16 @@ static void f_parser (lua_State *L, void *ud) {
   tf = ((c == LUA_SIGNATURE[0]) ? luaU_undump : luaY_parser)(L, p->z,
                                                              &p->buff, p->name);
 #else
-  if (c == LUA_SIGNATURE[0])
-		luaG_runerror(L, "invalid format, cannot load bytecode scripts");
-  tf = luaY_parser(L, p->z, &p->buff, p->name);
+  if (p->bytecode) {  /* engine-written cache, never addon data */
+    if (c != LUA_SIGNATURE[0])
+      luaG_runerror(L, "invalid format, expected bytecode");
+    tf = luaU_undump(L, p->z, &p->buff, p->name);
+  }
+  else {
+    if (c == LUA_SIGNATURE[0])
+      luaG_runerror(L, "invalid format, cannot load bytecode scripts");
+    tf = luaY_parser(L, p->z, &p->buff, p->name);
+  }
 #endif
   cl = luaF_newLclosure(L, tf->nups, hvalue(gt(L)));
   cl->l.p = tf;
@@ -524,10 +532,11 @@ static void f_parser (lua_State *L, void *ud) {
 }
 
 
-int luaD_protectedparser (lua_State *L, ZIO *z, const char *name) {
+int luaD_protectedparser (lua_State *L, ZIO *z, const char *name,
+                          int bytecode) {
   struct SParser p;
   int status;
-  p.z = z; p.name = name;
+  p.z = z; p.name = name; p.bytecode = bytecode;
   luaZ_initbuffer(L, &p.buff);
   status = luaD_pcall(L, f_parser, &p, savestack(L, L->top), L->errfunc);
   luaZ_freebuffer(L, &p.buff);
@@ -166,19 +166,20 @@ static int StartsWith(const char *a, const char *b) // this is wolfs being lazy
 }
 
 
-static int io_open (lua_State *L) {
-	FILE **pf;
-	const char *filename = luaL_checkstring(L, 1);
+// Scripts may only touch whitelisted file types in srb2home/luafiles.
+// Returns the real path of filename there, creating directories as needed,
+// or raises an error if the script isn't allowed to open it.
+static char *LuaFilePath (lua_State *L, const char *filename) {
 	int pass = 0;
 	size_t i;
-	int length = strlen(filename);
+	size_t length = strlen(filename);
 	char *splitter, *forward, *backward;
 	char *destFilename;
-	const char *mode = luaL_optstring(L, 2, "r");
 
 	for (i = 0; i < (sizeof (whitelist) / sizeof(const char *)); i++)
 	{
-		if (!stricmp(&filename[length - strlen(whitelist[i])], whitelist[i]))
+		if (length >= strlen(whitelist[i])
+			&& !stricmp(&filename[length - strlen(whitelist[i])], whitelist[i]))
 		{
 			pass = 1;
 			break;
@@ -188,7 +189,7 @@ static int io_open (lua_State *L) {
 		|| StartsWith(filename, "/") || !pass)
 	{
 		luaL_error(L,"access denied to %s", filename);
-		return pushresult(L,0,filename);
+		return NULL;
 	}
 
 	destFilename = va("%s"PATHSEP"luafiles"PATHSEP"%s", srb2home, filename);
@@ -209,6 +210,16 @@ static int io_open (lua_State *L) {
         backward = strchr(splitter, '\\');
 	}
 
+	return destFilename;
+}
+
+
+static int io_open (lua_State *L) {
+	FILE **pf;
+	const char *filename = luaL_checkstring(L, 1);
+	const char *mode = luaL_optstring(L, 2, "r");
+	char *destFilename = LuaFilePath(L, filename);
+
 	pf = newfile(L);
 	*pf = fopen(destFilename, mode);
 	return (*pf == NULL) ? pushresult(L, 0, filename) : 1;
@@ -236,8 +247,9 @@ static int g_iofile (lua_State *L, int f, const char *mode) {
   if (!lua_isnoneornil(L, 1)) {
     const char *filename = lua_tostring(L, 1);
     if (filename) {
+      char *destFilename = LuaFilePath(L, filename);
       FILE **pf = newfile(L);
-      *pf = fopen(filename, mode);
+      *pf = fopen(destFilename, mode);
       if (*pf == NULL)
         fileerror(L, 1, filename);
     }
@@ -288,8 +300,9 @@ static int io_lines (lua_State *L) {
   }
   else {
     const char *filename = luaL_checkstring(L, 1);
+    char *destFilename = LuaFilePath(L, filename);
     FILE **pf = newfile(L);
-    *pf = fopen(filename, "r");
+    *pf = fopen(destFilename, "r");
     if (*pf == NULL)
       fileerror(L, 1, filename);
     aux_lines(L, lua_gettop(L), 1);
@@ -4563,12 +4563,12 @@ static INT16 Consistancy(void)
 		ret += P_GetRandSeed();
 
 #ifdef MOBJCONSISTANCY
-	if (!thinkercap.next)
+	if (!thlist[THINK_MOBJ].cnext)
 	{
 		DEBFILE(va("Consistancy = %u\n", ret));
 		return ret;
 	}
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -4984,6 +4984,9 @@ boolean TryRunTics(tic_t realtics)
 					PS_STOP_TIMING(ps_tictime);
 					PS_UpdateTickStats();
 				}
+
+				// collect Lua garbage outside of the timed tic
+				LUA_Step();
 			}
 	}
 	else
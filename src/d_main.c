@@ -92,6 +92,7 @@ int	snprintf(char *str, size_t n, const char *fmt, ...);
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h" // 3D View Rendering
+#include "hardware/hw_batching.h" // 2D batching
 #endif
 
 #ifdef _WINDOWS
@@ -297,6 +298,12 @@ static void D_Display(void)
 		}
 	}
 
+#ifdef HWRENDER
+	// merge the 2D graphics of the frame into as few draw calls as possible
+	if (rendermode == render_opengl && cv_grbatching.value)
+		HWR_Start2DBatching();
+#endif
+
 	// do buffered drawing
 	switch (gamestate)
 	{
@@ -363,6 +370,11 @@ static void D_Display(void)
 		// draw the view directly
 		if (cv_renderview.value && !automapactive)
 		{
+#ifdef HWRENDER
+			// the level is drawn on its own, 2D batching resumes after it
+			if (rendermode == render_opengl)
+				HWR_End2DBatching();
+#endif
 			PS_START_TIMING(ps_rendercalltime);
 
 			R_ApplyLevelInterpolators(R_UsingFrameInterpolation() ? rendertimefrac : FRACUNIT);
@@ -415,6 +427,10 @@ static void D_Display(void)
 			R_RestoreLevelInterpolators();
 
 			PS_STOP_TIMING(ps_rendercalltime);
+#ifdef HWRENDER
+			if (rendermode == render_opengl && cv_grbatching.value)
+				HWR_Start2DBatching();
+#endif
 		}
 
 		if (lastdraw)
@@ -466,6 +482,11 @@ static void D_Display(void)
 
 	CON_Drawer();
 
+#ifdef HWRENDER
+	if (rendermode == render_opengl)
+		HWR_End2DBatching();
+#endif
+
 	//
 	// wipe update
 	//
@@ -540,7 +561,7 @@ tic_t rendergametic;
 
 void D_SRB2Loop(void)
 {
-	tic_t entertic = 0, oldentertics = 0, realtics = 0, rendertimeout = INFTICS;
+	tic_t entertic = 0, oldentertics = 0, realtics = 0, rendertimeout = INFTICS, oldgametic;
 	double deltatics = 0.0;
 	double deltasecs = 0.0;
 
@@ -648,8 +669,14 @@ void D_SRB2Loop(void)
 				realtics = 1;
 
 			// process tics (but maybe not if realtic == 0)
+			oldgametic = gametic;
 			TryRunTics(realtics);
 
+			// Lua garbage is collected after every tic. While none run,
+			// joining or waiting on the server, HUD hooks still allocate.
+			if (gametic == oldgametic)
+				LUA_Step();
+
 			if (lastdraw || singletics || gametic > rendergametic)
 			{
 				rendergametic = gametic;
@@ -728,9 +755,6 @@ void D_SRB2Loop(void)
 		HW3S_EndFrameUpdate();
 #endif
 
-		LUA_Step();
-
-
 		// Fully completed frame made.
 		finishprecise = I_GetPreciseTime();
 		if (!singletics)
@@ -225,6 +225,11 @@ consvar_t cv_respawntime = {"respawndelay", "3", CV_NETVAR|CV_CHEAT, respawntime
 
 consvar_t cv_competitionboxes = {"competitionboxes", "Random", CV_NETVAR|CV_CHEAT, competitionboxes_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+// Let objects far away from every player stop thinking (see P_MobjIsDormant)
+static CV_PossibleValue_t mobjdormancydist_cons_t[] = {{1024, "MIN"}, {32767, "MAX"}, {0, NULL}};
+consvar_t cv_mobjdormancy = {"mobjdormancy", "Off", CV_NETVAR, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_mobjdormancydist = {"mobjdormancydist", "6144", CV_NETVAR, mobjdormancydist_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+
 #ifdef SEENAMES
 static CV_PossibleValue_t seenames_cons_t[] = {{0, "Off"}, {1, "Colorless"}, {2, "Team"}, {3, "Ally/Foe"}, {0, NULL}};
 consvar_t cv_seenames = {"seenames", "Ally/Foe", CV_SAVE, seenames_cons_t, 0, 0, NULL, NULL, 0, 0, NULL};
@@ -376,7 +381,7 @@ consvar_t cv_sleep = {"cpusleep", "1", CV_SAVE, sleeping_cons_t, NULL, -1, NULL,
 consvar_t cv_freedemocamera = {"freedemocamera", "Off", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 static CV_PossibleValue_t perfstats_cons_t[] = {
-	{0, "Off"}, {1, "Rendering"}, {2, "Logic"}, {3, "ThinkFrame"}, {0, NULL}};
+	{0, "Off"}, {1, "Rendering"}, {2, "Logic"}, {3, "ThinkFrame"}, {4, "Thinkers"}, {0, NULL}};
 consvar_t cv_perfstats = {"perfstats", "Off", CV_CALL, perfstats_cons_t, PS_PerfStats_OnChange, 0, NULL, NULL, 0, 0, NULL};
 static CV_PossibleValue_t ps_samplesize_cons_t[] = {
 	{1, "MIN"}, {1000, "MAX"}, {0, NULL}};
@@ -384,6 +389,18 @@ consvar_t cv_ps_samplesize = {"ps_samplesize", "1", CV_CALL, ps_samplesize_cons_
 static CV_PossibleValue_t ps_descriptor_cons_t[] = {
 	{1, "Average"}, {2, "SD"}, {3, "Minimum"}, {4, "Maximum"}, {0, NULL}};
 consvar_t cv_ps_descriptor = {"ps_descriptor", "Average", 0, ps_descriptor_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t ps_thinkersort_cons_t[] = {
+	{1, "Time"}, {2, "Calls"}, {3, "PerCall"}, {0, NULL}};
+static CV_PossibleValue_t lua_gcbudget_cons_t[] = {{0, "MIN"}, {100000, "MAX"}, {0, NULL}};
+consvar_t cv_lua_gcbudget = {"lua_gcbudget", "1000", 0, lua_gcbudget_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_ps_thinkersort = {"ps_thinkersort", "Time", 0, ps_thinkersort_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+consvar_t cv_lua_bytecodecache = {"lua_bytecodecache", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t lua_hookwatchdog_cons_t[] = {{0, "Off"}, {1, "Warn"}, {2, "Abort"}, {0, NULL}};
+consvar_t cv_lua_hookwatchdog = {"lua_hookwatchdog", "Off", CV_NETVAR, lua_hookwatchdog_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t lua_hooktimelimit_cons_t[] = {{0, "MIN"}, {10000, "MAX"}, {0, NULL}};
+consvar_t cv_lua_hooktimelimit = {"lua_hooktimelimit", "10", CV_SAVE, lua_hooktimelimit_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
+static CV_PossibleValue_t lua_hookinstrlimit_cons_t[] = {{0, "MIN"}, {1000000000, "MAX"}, {0, NULL}};
+consvar_t cv_lua_hookinstrlimit = {"lua_hookinstrlimit", "0", CV_NETVAR, lua_hookinstrlimit_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 // Netplay Compatibility with 2.1.25
 #ifndef NONET
@@ -602,6 +619,9 @@ void D_RegisterServerCommands(void)
 	 CV_RegisterVar(&cv_allowseenames);
 #endif
 
+	CV_RegisterVar(&cv_mobjdormancy);
+	CV_RegisterVar(&cv_mobjdormancydist);
+
 	CV_RegisterVar(&cv_dummyconsvar);
 }
 
@@ -831,6 +851,16 @@ void D_RegisterClientCommands(void)
 	CV_RegisterVar(&cv_perfstats);
 	CV_RegisterVar(&cv_ps_samplesize);
 	CV_RegisterVar(&cv_ps_descriptor);
+	CV_RegisterVar(&cv_ps_thinkersort);
+	CV_RegisterVar(&cv_lua_gcbudget);
+	CV_RegisterVar(&cv_lua_bytecodecache);
+	CV_RegisterVar(&cv_lua_hookwatchdog);
+	CV_RegisterVar(&cv_lua_hooktimelimit);
+	CV_RegisterVar(&cv_lua_hookinstrlimit);
+	COM_AddCommand("luahookstats", Command_LuaHookStats_f);
+	COM_AddCommand("ps_thinkerdump", Command_ThinkerDump_f);
+	COM_AddCommand("luaprof", Command_LuaProf_f);
+	COM_AddCommand("luamem", Command_LuaMem_f);
 
 	// ingame object placing
 	COM_AddCommand("objectplace", Command_ObjectPlace_f);
@@ -875,6 +905,10 @@ void D_RegisterClientCommands(void)
 #if defined(LUA_ALLOW_BYTECODE)
 	COM_AddCommand("dumplua", Command_Dumplua_f);
 #endif
+#ifdef DEVELOP
+	COM_AddCommand("luahookbench", Command_LuaHookBench_f);
+	COM_AddCommand("luafieldbench", Command_LuaFieldBench_f);
+#endif
 }
 
 /** Checks if a name (as received from another player) is okay.
@@ -4153,7 +4187,7 @@ static void Command_Archivetest_f(void)
 
 	// assign mobjnum
 	i = 1;
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		if (th->function == (actionf_p1)P_MobjThinker)
 			((mobj_t *)th)->mobjnum = i++;
 
@@ -103,6 +103,8 @@ extern consvar_t cv_ringslinger, cv_soundtest;
 
 extern consvar_t cv_specialrings, cv_powerstones, cv_matchboxes, cv_competitionboxes;
 
+extern consvar_t cv_mobjdormancy, cv_mobjdormancydist;
+
 #ifdef NEWPING
 extern consvar_t cv_maxping;
 #endif
@@ -116,6 +118,12 @@ extern consvar_t cv_sleep;
 extern consvar_t cv_perfstats;
 extern consvar_t cv_ps_samplesize;
 extern consvar_t cv_ps_descriptor;
+extern consvar_t cv_ps_thinkersort;
+extern consvar_t cv_lua_gcbudget;
+extern consvar_t cv_lua_bytecodecache;
+extern consvar_t cv_lua_hookwatchdog;
+extern consvar_t cv_lua_hooktimelimit;
+extern consvar_t cv_lua_hookinstrlimit;
 
 extern consvar_t cv_freedemocamera;
 
@@ -39,6 +39,11 @@ typedef struct thinker_s
 	struct thinker_s *next;
 	think_t function;
 
+	// Links in the per-class list (see thlist in p_local.h), kept in the
+	// same relative order as the main list above.
+	struct thinker_s *cprev;
+	struct thinker_s *cnext;
+
 	// killough 11/98: count of how many other objects reference
 	// this one using pointers. Used for garbage collection.
 	INT32 references;
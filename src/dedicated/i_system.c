@@ -41,6 +41,7 @@ typedef DWORD (WINAPI *p_timeGetTime) (void);
 typedef UINT (WINAPI *p_timeEndPeriod) (UINT);
 typedef HANDLE (WINAPI *p_OpenFileMappingA) (DWORD, BOOL, LPCSTR);
 typedef LPVOID (WINAPI *p_MapViewOfFile) (HANDLE, DWORD, DWORD, DWORD, SIZE_T);
+typedef BOOLEAN (WINAPI *p_RtlGenRandom) (PVOID, ULONG);
 #endif
 #include <stdio.h>
 #include <stdlib.h>
@@ -1855,6 +1856,38 @@ static long get_entry(const char* name, const char* buf)
 }
 #endif
 
+// Fills buf with unpredictable bytes from the operating system.
+boolean I_GetRandomBytes(void *buf, size_t len)
+{
+#ifdef _WIN32
+	// RtlGenRandom, which advapi32 exports as SystemFunction036
+	static p_RtlGenRandom pfnRtlGenRandom = NULL;
+	static boolean tested = false;
+
+	if (!tested)
+	{
+		HMODULE advapi = LoadLibraryA("advapi32.dll");
+		if (advapi)
+			pfnRtlGenRandom = (p_RtlGenRandom)(LPVOID)GetProcAddress(advapi, "SystemFunction036");
+		tested = true;
+	}
+	return (pfnRtlGenRandom && pfnRtlGenRandom(buf, (ULONG)len));
+#elif defined (__unix__) || defined(__APPLE__) || defined (UNIXCOMMON)
+	FILE *f = fopen("/dev/urandom", "rb");
+	boolean filled;
+
+	if (!f)
+		return false;
+	filled = (fread(buf, 1, len, f) == len);
+	fclose(f);
+	return filled;
+#else
+	(void)buf;
+	(void)len;
+	return false;
+#endif
+}
+
 size_t I_GetFreeMem(size_t *total)
 {
 #ifdef FREEBSD
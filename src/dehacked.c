@@ -7345,6 +7345,17 @@ static mobjtype_t get_mobjtype(const char *word)
 	return MT_BLUECRAWLA;
 }
 
+// Returns the name of an object type without its MT_ prefix,
+// or NULL for an unused freeslot.
+const char *DEH_MobjTypeName(mobjtype_t type)
+{
+	if (type < MT_FIRSTFREESLOT)
+		return MOBJTYPE_LIST[type]+3;
+	if (type < NUMMOBJTYPES)
+		return FREE_MOBJS[type-MT_FIRSTFREESLOT];
+	return NULL;
+}
+
 static statenum_t get_state(const char *word)
 { // Returns the value of S_ enumerations
 	statenum_t i;
@@ -14,6 +14,7 @@
 #define __DEHACKED_H__
 
 #include "m_fixed.h" // for get_number
+#include "info.h" // for mobjtype_t
 
 typedef enum
 {
@@ -40,6 +41,7 @@ void DEH_LoadDehackedLumpPwad(UINT16 wad, UINT16 lump);
 void DEH_Check(void);
 
 fixed_t get_number(const char *word);
+const char *DEH_MobjTypeName(mobjtype_t type);
 
 boolean LUA_SetLuaAction(void *state, const char *actiontocompare);
 const char *LUA_GetActionName(void *action);
@@ -5,6 +5,13 @@ UINT8 graphics_started = 0;
 
 UINT8 keyboard_started = 0;
 
+boolean I_GetRandomBytes(void *buf, size_t len)
+{
+	(void)buf;
+	(void)len;
+	return false;
+}
+
 size_t I_GetFreeMem(size_t *total)
 {
 	*total = 0;
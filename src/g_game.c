@@ -2536,7 +2536,7 @@ void G_ChangePlayerReferences(mobj_t *oldmo, mobj_t *newmo)
 	I_Assert((oldmo != NULL) && (newmo != NULL));
 
 	// scan all thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -3822,7 +3822,7 @@ char *G_BuildMapTitle(INT32 mapnum)
 // DEMO RECORDING
 //
 
-#define DEMOVERSION 0x0009
+#define DEMOVERSION 0x000B
 #define DEMOHEADER  "\xF0" "SRB2Replay" "\x0F"
 
 #define DF_GHOST        0x01 // This demo contains ghost data too!
@@ -4277,7 +4277,7 @@ void G_ConsGhostTic(void)
 				demo_p += sizeof(angle_t); // angle, unnecessary for cons.
 
 				mobj = NULL;
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 				{
 					if (th->function != (actionf_p1)P_MobjThinker)
 						continue;
@@ -4996,6 +4996,7 @@ UINT8 G_CmpDemoTime(char *oldname, char *newname)
 	case DEMOVERSION: // latest always supported
 	// compatibility available?
 	case 0x0008:
+	case 0x0009:
 	case 0x000A:
 		break;
 	// too old, cannot support.
@@ -5135,9 +5136,16 @@ void G_DoPlayDemo(char *defdemoname)
 	switch(demoversion)
 	{
 	case DEMOVERSION: // latest always supported
+		break;
 	// compatibility available?
 	case 0x0008:
+	case 0x0009:
 	case 0x000A:
+		// Things think and collide in a different order since 0x000B,
+		// so anything that touches many objects at once can play out
+		// differently.
+		if (!titledemo)
+			CONS_Alert(CONS_WARNING, M_GetText("%s was recorded with an older version and may desync.\n"), pdemoname);
 		break;
 	// too old, cannot support.
 	default:
@@ -5356,6 +5364,7 @@ void G_AddGhost(char *defdemoname)
 	case DEMOVERSION: // latest always supported
 	// compatibility available?
 	case 0x0008:
+	case 0x0009:
 		break;
 	// too old, cannot support.
 	default:
@@ -5555,7 +5564,7 @@ void G_DoPlayMetal(void)
 		metalbuffer = metal_p = W_CacheLumpNum(l, PU_STATIC);
 
 	// find metal sonic
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -5581,6 +5590,7 @@ void G_DoPlayMetal(void)
 	case DEMOVERSION: // latest always supported
 	// compatibility available?
 	case 0x0008:
+	case 0x0009:
 		break;
 	// too old, cannot support.
 	default:
@@ -20,6 +20,22 @@ GLMipmap_t *current_texture = NULL;
 
 boolean currently_batching = false;
 
+// 2D batching state. HUD, menu and console graphics have to be drawn in the
+// order they were submitted, so instead of sorting like the 3D batches do,
+// consecutive quads that share the same texture, polyflags and color are
+// merged into a single indexed draw. The run is flushed when the state changes.
+boolean currently_batching_2d = false;
+
+static FOutVector *twodVertexArray = NULL;
+static UINT32 *twodIndexArray = NULL;
+static int twodVertexArraySize = 0;
+static int twodIndexArraySize = 0;
+static int twodVertexArrayAllocSize = 4096;
+
+static GLMipmap_t *twodTexture = NULL;
+static FBITFIELD twodPolyFlags = 0;
+static FSurfaceInfo twodSurf;
+
 FOutVector* finalVertexArray = NULL;// contains subset of sorted vertices and texture coordinates to be sent to gpu
 UINT32* finalVertexIndexArray = NULL;// contains indexes for glDrawElements, taking into account fan->triangles conversion
 //     NOTE have this alloced as 3x finalVertexArray size
@@ -63,7 +79,7 @@ void HWR_StartBatching(void)
 // Doing this was easier than getting a texture pointer to HWR_ProcessPolygon.
 void HWR_SetCurrentTexture(GLMipmap_t *texture)
 {
-    if (currently_batching)
+    if (currently_batching || currently_batching_2d)
     {
         current_texture = texture;
     }
@@ -418,4 +434,115 @@ void HWR_RenderBatches(void)
 }
 
 
+// Enables 2D batching mode. HWR_Process2DPolygon will merge consecutive polygons
+// with identical state, until HWR_End2DBatching is called.
+void HWR_Start2DBatching(void)
+{
+	if (currently_batching_2d)
+		I_Error("Repeat call to HWR_Start2DBatching without HWR_End2DBatching");
+
+	if (!twodVertexArray)
+	{
+		twodVertexArray = malloc(twodVertexArrayAllocSize * sizeof(FOutVector));
+		twodIndexArray = malloc(twodVertexArrayAllocSize * 3 * sizeof(UINT32));
+	}
+
+	ps_hw_num2dpolys.value.i = ps_hw_num2dcalls.value.i = 0;
+	currently_batching_2d = true;
+}
+
+// Draws the pending run of 2D polygons, if there is one.
+// Must be called before anything else touches the rendering backend
+// while 2D batching is active, otherwise the drawing order will break.
+void HWR_Flush2DBatch(void)
+{
+	if (!twodIndexArraySize)
+		return;
+
+	// the texture may have been unbound by uploads during collection
+	if (!(twodPolyFlags & PF_NoTexture))
+		HWD.pfnSetTexture(twodTexture);
+	HWD.pfnDrawIndexedTriangles(&twodSurf, twodVertexArray, twodIndexArraySize, twodPolyFlags, twodIndexArray);
+	ps_hw_num2dcalls.value.i++;
+
+	twodVertexArraySize = 0;
+	twodIndexArraySize = 0;
+}
+
+// Draws the pending run and disables 2D batching mode.
+void HWR_End2DBatching(void)
+{
+	if (!currently_batching_2d)
+		return;
+
+	HWR_Flush2DBatch();
+	currently_batching_2d = false;
+}
+
+// If 2D batching is enabled, appends the polygon to the pending run,
+// flushing the run first if the polygon needs a different state.
+// Otherwise the polygon is rendered immediately.
+void HWR_Process2DPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FUINT iNumPts, FBITFIELD PolyFlags)
+{
+	RGBA_t color;
+	int firstIndex, i;
+
+	// DrawIndexedTriangles doesn't restore the clamping that these flags change,
+	// so polygons using them are always drawn on their own.
+	if (!currently_batching_2d || (PolyFlags & (PF_ForceWrapX|PF_ForceWrapY|PF_RemoveYWrap|PF_Corona)))
+	{
+		HWR_Flush2DBatch();
+		if (currently_batching_2d && !(PolyFlags & PF_NoTexture))
+			HWD.pfnSetTexture(current_texture);
+		HWD.pfnDrawPolygon(pSurf, pOutVerts, iNumPts, PolyFlags);
+		return;
+	}
+
+	// a null surface means the color is never used, so treat it as plain white
+	if (pSurf && (PolyFlags & PF_Modulated))
+		color = pSurf->PolyColor;
+	else
+		color.rgba = 0xffffffff;
+
+	if (twodIndexArraySize
+		&& (twodPolyFlags != PolyFlags
+		|| twodSurf.PolyColor.rgba != color.rgba
+		|| (!(PolyFlags & PF_NoTexture) && twodTexture != current_texture)))
+		HWR_Flush2DBatch();
+
+	if (!twodIndexArraySize)
+	{
+		if (pSurf)
+			twodSurf = *pSurf;
+		else
+			memset(&twodSurf, 0, sizeof (twodSurf));
+		twodSurf.PolyColor = color;
+		twodPolyFlags = PolyFlags;
+		twodTexture = (PolyFlags & PF_NoTexture) ? NULL : current_texture;
+	}
+
+	while (twodVertexArraySize + (int)iNumPts > twodVertexArrayAllocSize)
+	{
+		// need more space, double the size of both arrays
+		twodVertexArrayAllocSize *= 2;
+		twodVertexArray = realloc(twodVertexArray, twodVertexArrayAllocSize * sizeof(FOutVector));
+		twodIndexArray = realloc(twodIndexArray, twodVertexArrayAllocSize * 3 * sizeof(UINT32));
+		if (!twodVertexArray || !twodIndexArray)
+			I_Error("HWR_Process2DPolygon: Out of memory");
+	}
+
+	// write the vertices, and the indexes for converting the fan to triangles
+	memcpy(&twodVertexArray[twodVertexArraySize], pOutVerts, iNumPts * sizeof(FOutVector));
+	firstIndex = twodVertexArraySize;
+	for (i = 2; i < (int)iNumPts; i++)
+	{
+		twodIndexArray[twodIndexArraySize++] = firstIndex;
+		twodIndexArray[twodIndexArraySize++] = firstIndex + i - 1;
+		twodIndexArray[twodIndexArraySize++] = firstIndex + i;
+	}
+	twodVertexArraySize += iNumPts;
+
+	ps_hw_num2dpolys.value.i++;
+}
+
 #endif // HWRENDER
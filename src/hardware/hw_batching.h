@@ -35,4 +35,11 @@ void HWR_SetCurrentTexture(GLMipmap_t *texture);
 void HWR_ProcessPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FUINT iNumPts, FBITFIELD PolyFlags, int shader, boolean horizonSpecial);
 void HWR_RenderBatches(void);
 
+extern boolean currently_batching_2d;
+
+void HWR_Start2DBatching(void);
+void HWR_Process2DPolygon(FSurfaceInfo *pSurf, FOutVector *pOutVerts, FUINT iNumPts, FBITFIELD PolyFlags);
+void HWR_Flush2DBatch(void);
+void HWR_End2DBatching(void);
+
 #endif
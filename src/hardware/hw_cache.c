@@ -396,6 +396,9 @@ static void FreeMipmapColormap(INT32 patchnum, void *patch)
 void HWR_FreeTextureCache(void)
 {
 	INT32 i;
+	// pending 2D polygons may still reference these textures
+	HWR_Flush2DBatch();
+
 	// free references to the textures
 	HWD.pfnClearMipMapCache();
 
@@ -436,6 +439,8 @@ void HWR_PrepLevelCache(size_t pnumtextures)
 
 void HWR_SetPalette(RGBA_t *palette)
 {
+	// the driver flushes its textures when the palette changes
+	HWR_Flush2DBatch();
 	HWD.pfnSetPalette(palette);
 
 	// hardware driver will flush there own cache if cache is non paletized
@@ -583,7 +588,11 @@ void HWR_GetPatch(GLPatch_t *gpatch)
 		Z_Free(patch);
 	}
 
-	HWD.pfnSetTexture(gpatch->mipmap);
+	// If hardware does not have the texture, then call pfnSetTexture to upload it
+	if (!gpatch->mipmap->downloaded)
+		HWD.pfnSetTexture(gpatch->mipmap);
+
+	HWR_SetCurrentTexture(gpatch->mipmap);
 
 	// The system-memory patch data can be purged now.
 	Z_ChangeTag(gpatch->mipmap->grInfo.data, PU_HWRCACHE_UNLOCKED);
@@ -125,6 +125,8 @@ consvar_t cv_grbatching = {"gr_batching", "On", 0, CV_OnOff, NULL, 0, NULL, NULL
 
 consvar_t cv_grwireframe = {"gr_wireframe", "Off", 0, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
+consvar_t cv_grfrustumculling = {"gr_frustumculling", "On", 0, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
+
 consvar_t cv_grmodellighting = {"gr_modellighting", "Off", CV_SAVE|CV_CALL, CV_OnOff, CV_grmodellighting_OnChange, 0, NULL, NULL, 0, 0, NULL};
 
 consvar_t cv_grshearing = {"gr_shearing", "Off", CV_SAVE, grshearing_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL};
@@ -239,6 +241,8 @@ ps_metric_t ps_hw_nodesorttime = {0};
 ps_metric_t ps_hw_nodedrawtime = {0};
 ps_metric_t ps_hw_spritesorttime = {0};
 ps_metric_t ps_hw_spritedrawtime = {0};
+ps_metric_t ps_hw_numfrustumculled = {0};
+ps_metric_t ps_hw_numclipculled = {0};
 
 // Render stats for batching
 ps_metric_t ps_hw_numpolys = {0};
@@ -250,6 +254,8 @@ ps_metric_t ps_hw_numpolyflags = {0};
 ps_metric_t ps_hw_numcolors = {0};
 ps_metric_t ps_hw_batchsorttime = {0};
 ps_metric_t ps_hw_batchdrawtime = {0};
+ps_metric_t ps_hw_num2dpolys = {0};
+ps_metric_t ps_hw_num2dcalls = {0};
 
 // ==========================================================================
 //   Lighting
@@ -760,6 +766,7 @@ static void HWR_DrawSegsSplats(FSurfaceInfo * pSurf)
 
 		gpatch = W_CachePatchNum(splat->patch, PU_CACHE);
 		HWR_GetPatch(gpatch);
+		HWD.pfnSetTexture(gpatch->mipmap); // drawn directly, even while batching
 
 		wallVerts[0].x = wallVerts[3].x = FIXED_TO_FLOAT(splat->v1.x);
 		wallVerts[0].z = wallVerts[3].z = FIXED_TO_FLOAT(splat->v1.y);
@@ -3384,6 +3391,358 @@ static void HWR_Subsector(size_t num)
 	sub->validcount = validcount;
 }
 
+// --------------------------------------------------------------------------
+// Frustum culling
+// --------------------------------------------------------------------------
+// HWR_CheckBBox only clips by view angle, so it can't reject geometry that
+// is above, below or behind the view when looking up or down. Before the
+// angle clip, node bounding boxes are tested against the full view frustum.
+
+// Float bounding boxes for both children of every BSP node.
+// x/y never change so they are converted once per level. z is kept in
+// fixed point too, so changes can be detected exactly, and is updated
+// incrementally: only the nodes above a sector whose range moved are redone.
+typedef struct
+{
+	float x1, y1, z1;
+	float x2, y2, z2;
+	fixed_t zlo, zhi;
+} gr_nodebox_t;
+
+static gr_nodebox_t *gr_nodeboxes = NULL; // numnodes*2, indexed by node*2 + child
+static INT32 *gr_nodeparents = NULL; // numnodes, box index in the parent node or -1 for the root
+static INT32 *gr_subsectorparents = NULL; // numsubsectors, box index in the parent node
+static fixed_t *gr_sectorzranges = NULL; // numsectors*2, bottom and top
+static INT32 *gr_sectorsubsecstart = NULL; // numsectors+1, index into gr_sectorsubsecs
+static INT32 *gr_sectorsubsecs = NULL; // subsectors whose range depends on each sector
+static INT32 *gr_polysubsecs = NULL; // numPolyObjects, subsector each one was last seen in
+
+// Plane equations a*x + b*y + c*z + d, positive inside the frustum
+static float gr_frustum[6][4];
+static boolean gr_frustumactive = false;
+
+// Heights used for things that have no useful vertical bound (sky, slopes...)
+#define FRUSTUM_NOLIMIT 1.0e6f
+// Slack for planes lying exactly on a bound
+#define FRUSTUM_ZMARGIN 64.0f
+
+// Far clipping distance of the OpenGL driver
+#define FRUSTUM_FARPLANE 32768.0f
+
+// Vertical extent of everything drawn from a sector: its planes and FOFs.
+// Sprites can reach well past the height of their mobj, so sectors with
+// things in them are left unbounded rather than guessing how tall they are.
+static void HWR_SectorZRange(sector_t *sector, fixed_t *bottom, fixed_t *top)
+{
+	fixed_t lo = sector->floorheight, hi = sector->ceilingheight;
+	const boolean things = (sector->thinglist || sector->preciplist);
+	boolean nobottom = (things || sector->f_slope || sector->floorpic == skyflatnum || sector->heightsec != -1);
+	boolean notop = (things || sector->c_slope || sector->ceilingpic == skyflatnum || sector->heightsec != -1);
+	ffloor_t *rover;
+
+	for (rover = sector->ffloors; rover; rover = rover->next)
+	{
+		if (*rover->t_slope || *rover->b_slope)
+		{
+			nobottom = notop = true;
+			break;
+		}
+		lo = min(lo, *rover->bottomheight);
+		hi = max(hi, *rover->topheight);
+	}
+
+	*bottom = nobottom ? INT32_MIN : lo;
+	*top = notop ? INT32_MAX : hi;
+}
+
+// Vertical extent of a subsector. Segs draw FOF sides of the sector behind
+// them, so the back sectors are included too.
+static void HWR_SubsectorZRange(subsector_t *sub, fixed_t *bottom, fixed_t *top)
+{
+	const fixed_t *range = &gr_sectorzranges[(sub->sector - sectors)*2];
+	seg_t *seg = &segs[sub->firstline];
+	INT16 count = sub->numlines;
+
+	if (sub->polyList)
+	{
+		*bottom = INT32_MIN;
+		*top = INT32_MAX;
+		return;
+	}
+
+	*bottom = range[0];
+	*top = range[1];
+
+	for (; count--; seg++)
+	{
+		if (!seg->backsector)
+			continue;
+		range = &gr_sectorzranges[(seg->backsector - sectors)*2];
+		*bottom = min(*bottom, range[0]);
+		*top = max(*top, range[1]);
+	}
+}
+
+// Stores the height range of a node child. Returns false if it didn't change.
+static boolean HWR_SetNodeZRange(gr_nodebox_t *box, fixed_t bottom, fixed_t top)
+{
+	if (box->zlo == bottom && box->zhi == top)
+		return false;
+
+	box->zlo = bottom;
+	box->zhi = top;
+	box->z1 = (bottom == INT32_MIN) ? -FRUSTUM_NOLIMIT : FIXED_TO_FLOAT(bottom) - FRUSTUM_ZMARGIN;
+	box->z2 = (top == INT32_MAX) ? FRUSTUM_NOLIMIT : FIXED_TO_FLOAT(top) + FRUSTUM_ZMARGIN;
+	return true;
+}
+
+// Fills in the heights below a node, and links every node and subsector
+// to the box that holds it in its parent.
+static void HWR_BuildNodeZRange(INT32 bspnum, INT32 parent, fixed_t *bottom, fixed_t *top)
+{
+	if (bspnum & NF_SUBSECTOR)
+	{
+		const size_t num = (bspnum == -1) ? 0 : (size_t)(bspnum & ~NF_SUBSECTOR);
+		gr_subsectorparents[num] = parent;
+		HWR_SubsectorZRange(&subsectors[num], bottom, top);
+	}
+	else
+	{
+		gr_nodebox_t *box = &gr_nodeboxes[bspnum*2];
+		fixed_t lo, hi;
+		INT32 i;
+
+		gr_nodeparents[bspnum] = parent;
+		for (i = 0; i < 2; i++)
+		{
+			HWR_BuildNodeZRange(nodes[bspnum].children[i], bspnum*2 + i, &lo, &hi);
+			box[i].zlo = ~lo; // force HWR_SetNodeZRange to store it
+			HWR_SetNodeZRange(&box[i], lo, hi);
+		}
+
+		*bottom = min(box[0].zlo, box[1].zlo);
+		*top = max(box[0].zhi, box[1].zhi);
+	}
+}
+
+// Redoes the height range of a subsector and of the nodes above it,
+// stopping as soon as a node's range stays the same.
+static void HWR_RefreshSubsectorZRange(size_t num)
+{
+	INT32 parent = gr_subsectorparents[num];
+	fixed_t bottom, top;
+
+	HWR_SubsectorZRange(&subsectors[num], &bottom, &top);
+
+	while (parent != -1 && HWR_SetNodeZRange(&gr_nodeboxes[parent], bottom, top))
+	{
+		const gr_nodebox_t *box = &gr_nodeboxes[parent & ~1];
+		bottom = min(box[0].zlo, box[1].zlo);
+		top = max(box[0].zhi, box[1].zhi);
+		parent = gr_nodeparents[parent/2];
+	}
+}
+
+// Builds the node boxes and the tables used to keep them up to date.
+static void HWR_BuildNodeBoxes(void)
+{
+	size_t i, total;
+	INT32 *fill;
+	fixed_t bottom, top;
+
+	Z_Malloc(numnodes * 2 * sizeof(*gr_nodeboxes), PU_LEVEL, &gr_nodeboxes);
+	Z_Malloc(numnodes * sizeof(*gr_nodeparents), PU_LEVEL, &gr_nodeparents);
+	Z_Malloc(numsubsectors * sizeof(*gr_subsectorparents), PU_LEVEL, &gr_subsectorparents);
+	Z_Malloc(numsectors * 2 * sizeof(*gr_sectorzranges), PU_LEVEL, &gr_sectorzranges);
+	Z_Calloc((numsectors + 1) * sizeof(*gr_sectorsubsecstart), PU_LEVEL, &gr_sectorsubsecstart);
+	if (numPolyObjects)
+		Z_Malloc(numPolyObjects * sizeof(*gr_polysubsecs), PU_LEVEL, &gr_polysubsecs);
+
+	for (i = 0; i < numnodes*2; i++)
+	{
+		const fixed_t *bbox = nodes[i/2].bbox[i&1];
+		gr_nodeboxes[i].x1 = FIXED_TO_FLOAT(bbox[BOXLEFT]);
+		gr_nodeboxes[i].x2 = FIXED_TO_FLOAT(bbox[BOXRIGHT]);
+		gr_nodeboxes[i].y1 = FIXED_TO_FLOAT(bbox[BOXBOTTOM]);
+		gr_nodeboxes[i].y2 = FIXED_TO_FLOAT(bbox[BOXTOP]);
+	}
+
+	for (i = 0; i < numsectors; i++)
+		HWR_SectorZRange(&sectors[i], &gr_sectorzranges[i*2], &gr_sectorzranges[i*2 + 1]);
+
+	for (i = 0; i < (size_t)numPolyObjects; i++)
+		gr_polysubsecs[i] = PolyObjects[i].attached ? (INT32)(PolyObjects[i].subsector - subsectors) : -1;
+
+	// Which subsectors to redo when a sector's range changes:
+	// its own, and those with segs facing into it.
+	for (i = 0; i < numsubsectors; i++)
+	{
+		seg_t *seg = &segs[subsectors[i].firstline];
+		INT16 count = subsectors[i].numlines;
+
+		gr_sectorsubsecstart[subsectors[i].sector - sectors]++;
+		for (; count--; seg++)
+			if (seg->backsector)
+				gr_sectorsubsecstart[seg->backsector - sectors]++;
+	}
+	for (i = 0, total = 0; i <= numsectors; i++)
+	{
+		const size_t count = gr_sectorsubsecstart[i];
+		gr_sectorsubsecstart[i] = (INT32)total;
+		total += count;
+	}
+	Z_Malloc(max(total, 1) * sizeof(*gr_sectorsubsecs), PU_LEVEL, &gr_sectorsubsecs);
+	fill = Z_Malloc(numsectors * sizeof(*fill), PU_STATIC, NULL);
+	memcpy(fill, gr_sectorsubsecstart, numsectors * sizeof(*fill));
+	for (i = 0; i < numsubsectors; i++)
+	{
+		seg_t *seg = &segs[subsectors[i].firstline];
+		INT16 count = subsectors[i].numlines;
+
+		gr_sectorsubsecs[fill[subsectors[i].sector - sectors]++] = (INT32)i;
+		for (; count--; seg++)
+			if (seg->backsector)
+				gr_sectorsubsecs[fill[seg->backsector - sectors]++] = (INT32)i;
+	}
+	Z_Free(fill);
+
+	HWR_BuildNodeZRange((INT32)numnodes-1, -1, &bottom, &top);
+}
+
+// Brings the node heights up to date with sectors that moved, gained or
+// lost things, and polyobjects that changed subsector since last frame.
+static void HWR_UpdateNodeBoxes(void)
+{
+	size_t i;
+	INT32 j;
+
+	if (!gr_nodeboxes)
+	{
+		HWR_BuildNodeBoxes();
+		return;
+	}
+
+	for (i = 0; i < numsectors; i++)
+	{
+		fixed_t *range = &gr_sectorzranges[i*2];
+		fixed_t bottom, top;
+
+		HWR_SectorZRange(&sectors[i], &bottom, &top);
+		if (bottom == range[0] && top == range[1])
+			continue;
+
+		range[0] = bottom;
+		range[1] = top;
+		for (j = gr_sectorsubsecstart[i]; j < gr_sectorsubsecstart[i+1]; j++)
+			HWR_RefreshSubsectorZRange(gr_sectorsubsecs[j]);
+	}
+
+	for (j = 0; j < numPolyObjects; j++)
+	{
+		const INT32 num = PolyObjects[j].attached ? (INT32)(PolyObjects[j].subsector - subsectors) : -1;
+
+		if (num == gr_polysubsecs[j])
+			continue;
+
+		if (gr_polysubsecs[j] != -1)
+			HWR_RefreshSubsectorZRange(gr_polysubsecs[j]);
+		if (num != -1)
+			HWR_RefreshSubsectorZRange(num);
+		gr_polysubsecs[j] = num;
+	}
+}
+
+static void HWR_SetFrustumPlane(INT32 i, float a, float b, float c, float d)
+{
+	gr_frustum[i][0] = a;
+	gr_frustum[i][1] = b;
+	gr_frustum[i][2] = c;
+	gr_frustum[i][3] = d;
+}
+
+// Sets up the frustum planes for the current view from atransform.
+// The planes are derived the same way the driver builds its projection in
+// SetTransform, then widened a little so they never cut anything visible.
+static void HWR_SetupFrustum(void)
+{
+	const float yaw = (float)viewangle * (float)(M_PIl / ANGLE_180);
+	const float pitch = (float)(INT32)gr_aimingangle * (float)(M_PIl / ANGLE_180);
+	const float halftan = (float)tan(atransform.fovxangle * M_PIl / 360.0l);
+	float fx, fy, fz, rx, ry, ux, uy, uz;
+	float tx, ty;
+	INT32 i;
+
+	gr_frustumactive = (cv_grfrustumculling.value && numnodes);
+	if (!gr_frustumactive)
+		return;
+
+	// Tangents of the horizontal and vertical half-angles
+	if (atransform.splitscreen)
+	{
+		tx = 2.0f * 0.8f * halftan;
+		ty = 0.8f * halftan / atransform.scaley;
+	}
+	else
+	{
+		tx = halftan;
+		ty = halftan / atransform.scaley;
+	}
+
+	// Y-shearing moves the view window up or down instead of pitching the view
+	if (atransform.shearing)
+		ty *= 1.0f + fabsf(atransform.viewaiming * 2.0f / BASEVIDHEIGHT);
+
+	// Roll can turn the view in any direction, so use the circumscribed cone
+	if (atransform.roll)
+		tx = ty = sqrtf(tx*tx + ty*ty);
+
+	tx *= 1.05f;
+	ty *= 1.05f;
+
+	// Forward, right and up vectors of the view
+	fx = cosf(pitch) * cosf(yaw);
+	fy = cosf(pitch) * sinf(yaw);
+	fz = sinf(pitch);
+	rx = sinf(yaw);
+	ry = -cosf(yaw);
+	ux = -sinf(pitch) * cosf(yaw);
+	uy = -sinf(pitch) * sinf(yaw);
+	uz = cosf(pitch);
+
+	// Planes through the view point. For each of these the inside is where
+	// the offset along the right or up vector is within tangent * depth.
+	HWR_SetFrustumPlane(0, tx*fx - rx, tx*fy - ry, tx*fz, 0.0f); // right
+	HWR_SetFrustumPlane(1, tx*fx + rx, tx*fy + ry, tx*fz, 0.0f); // left
+	HWR_SetFrustumPlane(2, ty*fx - ux, ty*fy - uy, ty*fz - uz, 0.0f); // top
+	HWR_SetFrustumPlane(3, ty*fx + ux, ty*fy + uy, ty*fz + uz, 0.0f); // bottom
+	HWR_SetFrustumPlane(4, fx, fy, fz, 0.0f); // near (anything in front of the view)
+	HWR_SetFrustumPlane(5, -fx, -fy, -fz, FRUSTUM_FARPLANE * 1.05f); // far
+
+	// Move the planes from view-relative to world coordinates
+	for (i = 0; i < 6; i++)
+		gr_frustum[i][3] -= gr_frustum[i][0]*gr_viewx + gr_frustum[i][1]*gr_viewy + gr_frustum[i][2]*gr_viewz;
+}
+
+// Returns false if the box is entirely outside the frustum.
+static boolean HWR_BoxInFrustum(const gr_nodebox_t *box)
+{
+	INT32 i;
+
+	for (i = 0; i < 6; i++)
+	{
+		const float *plane = gr_frustum[i];
+
+		// test the corner furthest along the plane normal
+		if (plane[0] * (plane[0] > 0.0f ? box->x2 : box->x1)
+			+ plane[1] * (plane[1] > 0.0f ? box->y2 : box->y1)
+			+ plane[2] * (plane[2] > 0.0f ? box->z2 : box->z1)
+			+ plane[3] < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
 //
 // Renders all subsectors below a given node,
 //  traversing subtree recursively.
@@ -3424,11 +3783,23 @@ static void HWR_RenderBSPNode(INT32 bspnum)
 		// Decide which side the view point is on.
 		side = R_PointOnSide(viewx, viewy, bsp);
 		// Recursively divide front space.
-		HWR_RenderBSPNode(bsp->children[side]);
+		if (!gr_frustumactive || HWR_BoxInFrustum(&gr_nodeboxes[bspnum*2 + side]))
+			HWR_RenderBSPNode(bsp->children[side]);
+		else
+			ps_hw_numfrustumculled.value.i++;
 
 		// Possibly divide back space.
+		if (gr_frustumactive && !HWR_BoxInFrustum(&gr_nodeboxes[bspnum*2 + (side^1)]))
+		{
+			ps_hw_numfrustumculled.value.i++;
+			return;
+		}
+
 		if (!HWR_CheckBBox(bsp->bbox[side^1]))
+		{
+			ps_hw_numclipculled.value.i++;
 			return;
+		}
 
 		bspnum = bsp->children[side^1];
 	}
@@ -4456,46 +4827,115 @@ static inline void HWR_DrawPrecipitationSprite(gr_vissprite_t *spr)
 #endif
 
 // --------------------------------------------------------------------------
-// Sort vissprites by distance
+// Radix sort for draw ordering
 // --------------------------------------------------------------------------
 
-gr_vissprite_t* gr_vsprorder[MAXVISSPRITES];
+// Sort keys are packed into a flat array so the sort never has to chase
+// pointers back into the sprites or drawnodes it is ordering.
+typedef struct
+{
+	UINT64 key;
+	size_t index;
+} gr_sortkey_t;
+
+// Stable LSD radix sort of keys in ascending order, eight bits per pass.
+// A pass is skipped when every key has the same byte in that position,
+// so narrow keys only pay for the bytes that actually vary.
+// temp must have room for count entries; the result always ends up in keys.
+static void HWR_RadixSortKeys(gr_sortkey_t *keys, gr_sortkey_t *temp, size_t count)
+{
+	size_t counts[8][256];
+	gr_sortkey_t *src = keys, *dst = temp, *swap;
+	size_t i, sum, n;
+	INT32 pass, b;
 
-// For more correct transparency the transparent sprites would need to be
-// sorted and drawn together with transparent surfaces.
-static int CompareVisSprites(const void *p1, const void *p2)
+	if (count < 2)
+		return;
+
+	memset(counts, 0, sizeof(counts));
+	for (i = 0; i < count; i++)
+		for (pass = 0; pass < 8; pass++)
+			counts[pass][(keys[i].key >> (pass*8)) & 0xFF]++;
+
+	for (pass = 0; pass < 8; pass++)
+	{
+		size_t *bucket = counts[pass];
+		const INT32 shift = pass*8;
+
+		if (bucket[(src[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		for (b = 0, sum = 0; b < 256; b++)
+		{
+			n = bucket[b];
+			bucket[b] = sum;
+			sum += n;
+		}
+
+		for (i = 0; i < count; i++)
+			dst[bucket[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	if (src != keys)
+		M_Memcpy(keys, src, count * sizeof(*keys));
+}
+
+// Maps a float to an unsigned key that sorts in the same order.
+static UINT32 HWR_FloatSortKey(float f)
 {
-	gr_vissprite_t* spr1 = *(gr_vissprite_t*const*)p1;
-	gr_vissprite_t* spr2 = *(gr_vissprite_t*const*)p2;
-	int idiff;
-	float fdiff;
-
-	// make transparent sprites last
-	// "boolean to int"
-
-	int transparency1 = (spr1->mobj->flags2 & MF2_SHADOW) || (spr1->mobj->frame & FF_TRANSMASK);
-	int transparency2 = (spr2->mobj->flags2 & MF2_SHADOW) || (spr2->mobj->frame & FF_TRANSMASK);
-	idiff = transparency1 - transparency2;
-	if (idiff != 0) return idiff;
-
-	fdiff = spr2->tz - spr1->tz;// this order seems correct when checking with apitrace. Back to front.
-	if (fabsf(fdiff) < 1.0E-36f)
-		return spr1->dispoffset - spr2->dispoffset;// smallest dispoffset first if sprites are at (almost) same location.
-	else if (fdiff > 0)
-		return 1;
-	else
-		return -1;
+	union { float f; UINT32 u; } conv;
+
+	conv.f = f;
+	if ((conv.u & 0x7FFFFFFF) == 0)
+		conv.u = 0; // -0 and +0 compare equal, so give them the same key
+
+	return (conv.u & 0x80000000) ? ~conv.u : (conv.u | 0x80000000);
 }
 
+// --------------------------------------------------------------------------
+// Sort vissprites by distance
+// --------------------------------------------------------------------------
 
+gr_vissprite_t* gr_vsprorder[MAXVISSPRITES];
+
+static gr_sortkey_t gr_spritekeys[MAXVISSPRITES];
+static gr_sortkey_t gr_spritetemp[MAXVISSPRITES];
+
+// For more correct transparency the transparent sprites would need to be
+// sorted and drawn together with transparent surfaces.
+//
+// The order is the one the old CompareVisSprites qsort comparator gave:
+// opaque sprites first, then back to front by tz, then smallest dispoffset
+// first for sprites at the same depth. Since the radix sort is stable, this
+// is done as a sort on dispoffset followed by a sort on (transparency, tz).
 static void HWR_SortVisSprites(void)
 {
 	UINT32 i;
 	for (i = 0; i < gr_visspritecount; i++)
 	{
-		gr_vsprorder[i] = HWR_GetVisSprite(i);
+		gr_spritekeys[i].key = (UINT32)HWR_GetVisSprite(i)->dispoffset ^ 0x80000000;
+		gr_spritekeys[i].index = i;
 	}
-	qsort(gr_vsprorder, gr_visspritecount, sizeof(gr_vissprite_t*), CompareVisSprites);
+
+	HWR_RadixSortKeys(gr_spritekeys, gr_spritetemp, gr_visspritecount);
+
+	for (i = 0; i < gr_visspritecount; i++)
+	{
+		gr_vissprite_t *spr = HWR_GetVisSprite(gr_spritekeys[i].index);
+		const UINT64 transparent = (spr->mobj->flags2 & MF2_SHADOW) || (spr->mobj->frame & FF_TRANSMASK);
+
+		// make transparent sprites last, and far sprites before near ones
+		gr_spritekeys[i].key = (transparent << 32) | (UINT32)~HWR_FloatSortKey(spr->tz);
+	}
+
+	HWR_RadixSortKeys(gr_spritekeys, gr_spritetemp, gr_visspritecount);
+
+	for (i = 0; i < gr_visspritecount; i++)
+		gr_vsprorder[i] = HWR_GetVisSprite(gr_spritekeys[i].index);
 }
 
 // A drawnode is something that points to a 3D floor, 3D side, or masked
@@ -4641,45 +5081,25 @@ void HWR_AddTransparentPolyobjectFloor(lumpnum_t lumpnum, polyobj_t *polysector,
 	numpolyplanes++;
 }
 
-// putting sortindex and sortnode here so the comparator function can see them
 gr_drawnode_t *sortnode;
 size_t *sortindex;
 
-static int CompareDrawNodes(const void *p1, const void *p2)
+// Drawnodes are ordered by descending drawcount, i.e. in reverse order of
+// when they were added during BSP traversal. drawcount is never negative.
+static UINT64 HWR_DrawNodeSortKey(gr_drawnode_t *node)
 {
-	size_t n1 = *(const size_t*)p1;
-	size_t n2 = *(const size_t*)p2;
-	INT32 v1 = 0;
-	INT32 v2 = 0;
-	INT32 diff;
-	if (sortnode[n1].plane)
-		v1 = sortnode[n1].plane->drawcount;
-	else if (sortnode[n1].polyplane)
-		v1 = sortnode[n1].polyplane->drawcount;
-	else if (sortnode[n1].wall)
-		v1 = sortnode[n1].wall->drawcount;
-	else I_Error("CompareDrawNodes: n1 unknown");
-
-	if (sortnode[n2].plane)
-		v2 = sortnode[n2].plane->drawcount;
-	else if (sortnode[n2].polyplane)
-		v2 = sortnode[n2].polyplane->drawcount;
-	else if (sortnode[n2].wall)
-		v2 = sortnode[n2].wall->drawcount;
-	else I_Error("CompareDrawNodes: n2 unknown");
-
-	diff = v2 - v1;
-	if (diff == 0) I_Error("CompareDrawNodes: diff is zero");
-	return diff;
-}
+	INT32 v;
+
+	if (node->plane)
+		v = node->plane->drawcount;
+	else if (node->polyplane)
+		v = node->polyplane->drawcount;
+	else if (node->wall)
+		v = node->wall->drawcount;
+	else
+		I_Error("HWR_DrawNodeSortKey: node unknown");
 
-static int CompareDrawNodePlanes(const void *p1, const void *p2)
-{
-	size_t n1 = *(const size_t*)p1;
-	size_t n2 = *(const size_t*)p2;
-	if (!sortnode[n1].plane) I_Error("CompareDrawNodePlanes: Uh.. This isn't a plane! (n1)");
-	if (!sortnode[n2].plane) I_Error("CompareDrawNodePlanes: Uh.. This isn't a plane! (n2)");
-	return ABS(sortnode[n2].plane->fixedheight - viewz) - ABS(sortnode[n1].plane->fixedheight - viewz);
+	return ~(UINT32)v;
 }
 
 //
@@ -4689,6 +5109,7 @@ static void HWR_CreateDrawNodes(void)
 {
 	UINT32 i = 0, p = 0;
 	size_t run_start = 0;
+	gr_sortkey_t *sortkeys;
 
 	// Dump EVERYTHING into a huge drawnode list. Then we'll sort it!
 	// Could this be optimized into _AddTransparentWall/_AddTransparentPlane?
@@ -4701,6 +5122,7 @@ static void HWR_CreateDrawNodes(void)
 	// However, in reality we shouldn't be re-copying and shifting all this information
 	// that is already lying around. This should all be in some sort of linked list or lists.
 	sortindex = Z_Calloc(sizeof(size_t) * (numplanes + numpolyplanes + numwalls), PU_STATIC, NULL);
+	sortkeys = Z_Malloc(sizeof(gr_sortkey_t) * 2 * (numplanes + numpolyplanes + numwalls), PU_STATIC, NULL);
 
 	PS_START_TIMING(ps_hw_nodesorttime);
 
@@ -4728,7 +5150,14 @@ static void HWR_CreateDrawNodes(void)
 
 
 	// sort the list based on the value of the 'drawcount' member of the drawnodes.
-	qsort(sortindex, p, sizeof(size_t), CompareDrawNodes);
+	for (i = 0; i < p; i++)
+	{
+		sortkeys[i].key = HWR_DrawNodeSortKey(&sortnode[i]);
+		sortkeys[i].index = i;
+	}
+	HWR_RadixSortKeys(sortkeys, sortkeys + p, p);
+	for (i = 0; i < p; i++)
+		sortindex[i] = sortkeys[i].index;
 
 	// an additional pass is needed to correct the order of consecutive planes in the list.
 	// for each consecutive run of planes in the list, sort that run based on plane height and view height.
@@ -4746,8 +5175,19 @@ static void HWR_CreateDrawNodes(void)
 			run_end = i-1;
 			if (run_end > run_start)// if there are multiple consecutive planes, not just one
 			{
-				// consecutive run of planes found, now sort it
-				qsort(sortindex + run_start, run_end - run_start + 1, sizeof(size_t), CompareDrawNodePlanes);
+				// consecutive run of planes found, now sort it, farthest from the view height first
+				const size_t run_length = run_end - run_start + 1;
+				size_t j;
+
+				for (j = 0; j < run_length; j++)
+				{
+					const INT64 dist = (INT64)sortnode[sortindex[run_start + j]].plane->fixedheight - viewz;
+					sortkeys[j].key = UINT32_MAX - (UINT32)(dist < 0 ? -dist : dist);
+					sortkeys[j].index = sortindex[run_start + j];
+				}
+				HWR_RadixSortKeys(sortkeys, sortkeys + run_length, run_length);
+				for (j = 0; j < run_length; j++)
+					sortindex[run_start + j] = sortkeys[j].index;
 			}
 			run_start = run_end + 1;// continue looking for runs coming right after this one
 		}
@@ -4807,6 +5247,7 @@ HWR_RenderPlane(NULL, sortnode[sortindex[i]].plane->xsub, sortnode[sortindex[i]]
 	// No mem leaks, please.
 	Z_Free(sortnode);
 	Z_Free(sortindex);
+	Z_Free(sortkeys);
 }
 
 
@@ -5208,13 +5649,13 @@ static void HWR_ProjectPrecipitationSprite(precipmobj_t *thing)
 	x2 = tr_x - x2 * rightcos;
 
 	// okay, we can't return now... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
+	if (thing->thinktic != leveltime)
 	{
 		if (thing->precipflags & PCF_RAIN)
 			P_RainThinker(thing);
 		else
 			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
+		thing->thinktic = leveltime;
 	}
 
 	//
@@ -5711,6 +6152,8 @@ void HWR_RenderSkyboxView(INT32 viewnumber, player_t *player)
 
 	drawcount = 0;
 
+	HWR_SetupFrustum();
+
 #ifdef NEWCLIP
 	if (rendermode == render_opengl)
 	{
@@ -5813,6 +6256,11 @@ void HWR_RenderPlayerView(INT32 viewnumber, player_t *player)
 	if (viewnumber == 0) // Only do it if it's the first screen being rendered
 		HWD.pfnClearBuffer(true, false, &ClearColor); // Clear the Color Buffer, stops HOMs. Also seems to fix the skybox issue on Intel GPUs.
 
+	// The level looks the same from every view in a frame,
+	// so the frustum culling boxes only need updating once.
+	if (viewnumber == 0 && cv_grfrustumculling.value && numnodes)
+		HWR_UpdateNodeBoxes();
+
 	PS_START_TIMING(ps_skyboxtime);
 	if (skybox && drawsky) // If there's a skybox and we should be drawing the sky, draw the skybox
 		HWR_RenderSkyboxView(viewnumber, player); // This is drawn before everything else so it is placed behind
@@ -5904,6 +6352,8 @@ void HWR_RenderPlayerView(INT32 viewnumber, player_t *player)
 
 
 	drawcount = 0;
+	HWR_SetupFrustum();
+
 #ifdef NEWCLIP
 	if (rendermode == render_opengl)
 	{
@@ -5933,6 +6383,8 @@ void HWR_RenderPlayerView(INT32 viewnumber, player_t *player)
 
 	ps_numbspcalls.value.i = 0;
 	ps_numpolyobjects.value.i = 0;
+	ps_hw_numfrustumculled.value.i = 0;
+	ps_hw_numclipculled.value.i = 0;
 	PS_START_TIMING(ps_bsptime);
 
 	validcount++;
@@ -6022,6 +6474,7 @@ void HWR_AddCommands(void)
 	CV_RegisterVar(&cv_grsolvetjoin);
 	CV_RegisterVar(&cv_grbatching);
 	CV_RegisterVar(&cv_grwireframe);
+	CV_RegisterVar(&cv_grfrustumculling);
 	CV_RegisterVar(&cv_grmodellighting);
 	CV_RegisterVar(&cv_glloadingscreen);
 	CV_RegisterVar(&cv_grshearing);
@@ -6292,6 +6745,7 @@ void HWR_DoPostProcessor(player_t *player)
 void HWR_StartScreenWipe(void)
 {
 	//CONS_Debug(DBG_RENDER, "In HWR_StartScreenWipe()\n");
+	HWR_Flush2DBatch();
 	HWD.pfnStartScreenWipe();
 }
 
@@ -6299,11 +6753,13 @@ void HWR_EndScreenWipe(void)
 {
 	HWRWipeCounter = 0.0f;
 	//CONS_Debug(DBG_RENDER, "In HWR_EndScreenWipe()\n");
+	HWR_Flush2DBatch();
 	HWD.pfnEndScreenWipe();
 }
 
 void HWR_DrawIntermissionBG(void)
 {
+	HWR_Flush2DBatch();
 	HWD.pfnDrawIntermissionBG();
 }
 
@@ -6333,6 +6789,7 @@ void HWR_DoWipe(UINT8 wipenum, UINT8 scrnnum)
 
 	HWR_GetFadeMask(lumpnum);
 
+	HWR_Flush2DBatch();
 	HWD.pfnDoScreenWipe();
 
 	HWRWipeCounter += 0.05f; // increase opacity of end screen
@@ -6343,6 +6800,7 @@ void HWR_DoWipe(UINT8 wipenum, UINT8 scrnnum)
 
 void HWR_MakeScreenFinalTexture(void)
 {
+    HWR_Flush2DBatch();
     HWD.pfnMakeScreenFinalTexture();
 }
 
@@ -96,6 +96,7 @@ extern consvar_t cv_grfakecontrast;
 extern consvar_t cv_grslopecontrast;
 extern consvar_t cv_grbatching;
 extern consvar_t cv_grwireframe;
+extern consvar_t cv_grfrustumculling;
 
 extern float gr_viewwidth, gr_viewheight, gr_baseviewwindowy;
 
@@ -110,6 +111,8 @@ extern ps_metric_t ps_hw_nodesorttime;
 extern ps_metric_t ps_hw_nodedrawtime;
 extern ps_metric_t ps_hw_spritesorttime;
 extern ps_metric_t ps_hw_spritedrawtime;
+extern ps_metric_t ps_hw_numfrustumculled;
+extern ps_metric_t ps_hw_numclipculled;
 
 // Render stats for batching
 extern ps_metric_t ps_hw_numpolys;
@@ -121,6 +124,8 @@ extern ps_metric_t ps_hw_numpolyflags;
 extern ps_metric_t ps_hw_numcolors;
 extern ps_metric_t ps_hw_batchsorttime;
 extern ps_metric_t ps_hw_batchdrawtime;
+extern ps_metric_t ps_hw_num2dpolys;
+extern ps_metric_t ps_hw_num2dcalls;
 
 //bye bye floorinfo
 
@@ -21,6 +21,9 @@
 
 #include <stdarg.h>
 #include <math.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "../../r_local.h" // For rendertimefrac, used for the leveltime shader uniform
 #include "r_opengl.h"
 #include "r_vbo.h"
@@ -99,6 +102,8 @@ static void *Shader_Load(FSurfaceInfo *Surface, GLRGBAFloat *poly, GLRGBAFloat *
 static void Shader_SetUniforms(FSurfaceInfo *Surface, GLRGBAFloat *poly, GLRGBAFloat *tint, GLRGBAFloat *fade);
 static void Shader_CompileError(const char *message, GLuint program, INT32 shadernum);
 
+static void FlushModelPoses(void);
+
 static GLRGBAFloat shader_defaultcolor = {1.0f, 1.0f, 1.0f, 1.0f};
 
 // shortcut for ((float)1/i)
@@ -1406,6 +1411,7 @@ EXPORT void HWRAPI(ClearMipMapCache) (void)
 {
 	// GL_DBG_Printf ("HWR_Flush(exe)\n");
 	Flush();
+	FlushModelPoses();
 }
 
 
@@ -2385,47 +2391,163 @@ EXPORT void HWRAPI(SetSpecialState) (hwdspecialstate_t IdState, INT32 Value)
 	}
 }
 
-static float *vertBuffer = NULL;
-static float *normBuffer = NULL;
-static size_t lerpBufferSize = 0;
-static short *vertTinyBuffer = NULL;
-static char *normTinyBuffer = NULL;
-static size_t lerpTinyBufferSize = 0;
+// Interpolated model poses.
+// Instances of the same model are often drawn on the same frame pair and
+// tween (players sharing a skin, rows of identical badniks), so the lerped
+// vertex and normal arrays are cached by (mesh, frame, next frame, tween)
+// and reused until they are evicted, instead of being rebuilt per instance.
+// The tween only ever takes one of (duration + 1) values, so exact matches
+// are common and no quantization is needed; it is keyed by its bit pattern.
+#define POSECACHE_SETS 32
+#define POSECACHE_WAYS 4
+
+typedef struct
+{
+	const mesh_t *mesh;
+	INT32 frame;
+	INT32 nextframe;
+	UINT32 polbits;
+	UINT32 lastused;
+	void *vertices; // float, or short for tinyframes
+	void *normals; // float, or char for tinyframes
+	size_t vertsize, normsize;
+} modelpose_t;
+
+static modelpose_t poseCache[POSECACHE_SETS][POSECACHE_WAYS];
+static UINT32 poseCacheClock = 0;
+
+// Frees every cached pose. Called whenever the texture cache is flushed,
+// which also happens between levels.
+static void FlushModelPoses(void)
+{
+	int i, j;
+
+	for (i = 0; i < POSECACHE_SETS; i++)
+	{
+		for (j = 0; j < POSECACHE_WAYS; j++)
+		{
+			modelpose_t *pose = &poseCache[i][j];
+			free(pose->vertices);
+			free(pose->normals);
+		}
+	}
+
+	memset(poseCache, 0, sizeof(poseCache));
+	poseCacheClock = 0;
+}
 
-// Static temporary buffer for doing frame interpolation
-// 'size' is the vertex size
-static void AllocLerpBuffer(size_t size)
+// Finds the cached pose for this key, or claims the least recently used slot
+// of its set for it. Returns NULL only if the slot could not be allocated.
+// *cached is set to true if the returned pose already holds valid data.
+static modelpose_t *GetModelPose(const mesh_t *mesh, INT32 frame, INT32 nextframe, float pol,
+	size_t vertsize, size_t normsize, boolean *cached)
 {
-	if (lerpBufferSize >= size)
-		return;
+	UINT32 polbits;
+	size_t hash;
+	modelpose_t *set;
+	modelpose_t *pose;
+	int i;
+
+	memcpy(&polbits, &pol, sizeof polbits);
+	hash = ((size_t)mesh >> 4) ^ ((size_t)frame * 31) ^ ((size_t)nextframe * 131) ^ ((size_t)polbits >> 12);
+	set = poseCache[(hash ^ (hash >> 5)) % POSECACHE_SETS];
+	pose = &set[0];
 
-	if (vertBuffer != NULL)
-		free(vertBuffer);
+	poseCacheClock++;
 
-	if (normBuffer != NULL)
-		free(normBuffer);
+	for (i = 0; i < POSECACHE_WAYS; i++)
+	{
+		if (set[i].mesh == mesh && set[i].frame == frame && set[i].nextframe == nextframe
+			&& set[i].polbits == polbits && set[i].vertsize == vertsize)
+		{
+			set[i].lastused = poseCacheClock;
+			*cached = true;
+			return &set[i];
+		}
 
-	lerpBufferSize = size;
-	vertBuffer = malloc(lerpBufferSize);
-	normBuffer = malloc(lerpBufferSize);
+		if (set[i].lastused < pose->lastused)
+			pose = &set[i];
+	}
+
+	*cached = false;
+
+	if (pose->vertsize < vertsize || pose->normsize < normsize)
+	{
+		free(pose->vertices);
+		free(pose->normals);
+		pose->vertices = malloc(vertsize);
+		pose->normals = malloc(normsize);
+		if (!pose->vertices || !pose->normals)
+		{
+			free(pose->vertices);
+			free(pose->normals);
+			memset(pose, 0, sizeof(*pose));
+			return NULL;
+		}
+	}
+
+	pose->mesh = mesh;
+	pose->frame = frame;
+	pose->nextframe = nextframe;
+	pose->polbits = polbits;
+	pose->vertsize = vertsize;
+	pose->normsize = normsize;
+	pose->lastused = poseCacheClock;
+	return pose;
 }
 
-// Static temporary buffer for doing frame interpolation
-// 'size' is the vertex size
-static void AllocLerpTinyBuffer(size_t size)
+// Interpolation kernels.
+// These compute exactly a + pol * (b - a) per element, the same as the old
+// scalar loops did, just four (or eight) elements at a time where SSE2 is
+// available.
+static void LerpFloats(float *out, const float *a, const float *b, float pol, int count)
 {
-	if (lerpTinyBufferSize >= size)
-		return;
+	int i = 0;
+#ifdef __SSE2__
+	const __m128 vpol = _mm_set1_ps(pol);
 
-	if (vertTinyBuffer != NULL)
-		free(vertTinyBuffer);
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 va = _mm_loadu_ps(a + i);
+		const __m128 vb = _mm_loadu_ps(b + i);
+		_mm_storeu_ps(out + i, _mm_add_ps(va, _mm_mul_ps(vpol, _mm_sub_ps(vb, va))));
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = a[i] + (pol * (b[i] - a[i]));
+}
+
+static void LerpShorts(short *out, const short *a, const short *b, float pol, int count)
+{
+	int i = 0;
+#ifdef __SSE2__
+	const __m128 vpol = _mm_set1_ps(pol);
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m128i sa = _mm_loadu_si128((const __m128i *)(a + i));
+		const __m128i sb = _mm_loadu_si128((const __m128i *)(b + i));
+		// sign-extend to 32 bits
+		const __m128 alo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(zero, sa), 16));
+		const __m128 ahi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, sa), 16));
+		const __m128 blo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(zero, sb), 16));
+		const __m128 bhi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, sb), 16));
+		const __m128i rlo = _mm_cvttps_epi32(_mm_add_ps(alo, _mm_mul_ps(vpol, _mm_sub_ps(blo, alo))));
+		const __m128i rhi = _mm_cvttps_epi32(_mm_add_ps(ahi, _mm_mul_ps(vpol, _mm_sub_ps(bhi, ahi))));
+		_mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(rlo, rhi));
+	}
+#endif
+	for (; i < count; i++)
+		out[i] = (short)(a[i] + (pol * (b[i] - a[i])));
+}
 
-	if (normTinyBuffer != NULL)
-		free(normTinyBuffer);
+static void LerpChars(char *out, const char *a, const char *b, float pol, int count)
+{
+	int i;
 
-	lerpTinyBufferSize = size;
-	vertTinyBuffer = malloc(lerpTinyBufferSize);
-	normTinyBuffer = malloc(lerpTinyBufferSize / 2);
+	for (i = 0; i < count; i++)
+		out[i] = (char)(a[i] + (pol * (b[i] - a[i])));
 }
 
 #ifndef GL_STATIC_DRAW
@@ -2753,25 +2875,23 @@ static void DrawModelEx(model_t *model, INT32 frameIndex, INT32 duration, INT32
 			}
 			else
 			{
-				short *vertPtr;
-				char *normPtr;
-				int j = 0;
-
-				// Dangit, I soooo want to do this in a GLSL shader...
-				AllocLerpTinyBuffer(mesh->numVertices * sizeof(short) * 3);
-				vertPtr = vertTinyBuffer;
-				normPtr = normTinyBuffer;
+				const int count = mesh->numVertices * 3;
+				boolean cached;
+				modelpose_t *pose = GetModelPose(mesh, frameIndex % mesh->numFrames, nextFrameIndex % mesh->numFrames, pol,
+					count * sizeof(short), count * sizeof(char), &cached);
 
+				if (!pose)
+					continue;
 
-				for (j = 0; j < mesh->numVertices * 3; j++)
+				// Dangit, I soooo want to do this in a GLSL shader...
+				if (!cached)
 				{
-					// Interpolate
-					*vertPtr++ = (short)(frame->vertices[j] + (pol * (nextframe->vertices[j] - frame->vertices[j])));
-					*normPtr++ = (char)(frame->normals[j] + (pol * (nextframe->normals[j] - frame->normals[j])));
+					LerpShorts(pose->vertices, frame->vertices, nextframe->vertices, pol, count);
+					LerpChars(pose->normals, frame->normals, nextframe->normals, pol, count);
 				}
 
-				pglVertexPointer(3, GL_SHORT, 0, vertTinyBuffer);
-				pglNormalPointer(GL_BYTE, 0, normTinyBuffer);
+				pglVertexPointer(3, GL_SHORT, 0, pose->vertices);
+				pglNormalPointer(GL_BYTE, 0, pose->normals);
 				pglTexCoordPointer(2, GL_FLOAT, 0, mesh->uvs);
 				pglDrawElements(GL_TRIANGLES, mesh->numTriangles * 3, GL_UNSIGNED_SHORT, mesh->indices);
 			}
@@ -2804,25 +2924,23 @@ static void DrawModelEx(model_t *model, INT32 frameIndex, INT32 duration, INT32
 			}
 			else
 			{
-				float *vertPtr;
-				float *normPtr;
-				int j = 0;
+				const int count = mesh->numVertices * 3;
+				boolean cached;
+				modelpose_t *pose = GetModelPose(mesh, frameIndex % mesh->numFrames, nextFrameIndex % mesh->numFrames, pol,
+					count * sizeof(float), count * sizeof(float), &cached);
 
-				// Dangit, I soooo want to do this in a GLSL shader...
-				AllocLerpBuffer(mesh->numVertices * sizeof(float) * 3);
-				vertPtr = vertBuffer;
-				normPtr = normBuffer;
-				//int j = 0;
+				if (!pose)
+					continue;
 
-				for (j = 0; j < mesh->numVertices * 3; j++)
+				// Dangit, I soooo want to do this in a GLSL shader...
+				if (!cached)
 				{
-					// Interpolate
-					*vertPtr++ = frame->vertices[j] + (pol * (nextframe->vertices[j] - frame->vertices[j]));
-					*normPtr++ = frame->normals[j] + (pol * (nextframe->normals[j] - frame->normals[j]));
+					LerpFloats(pose->vertices, frame->vertices, nextframe->vertices, pol, count);
+					LerpFloats(pose->normals, frame->normals, nextframe->normals, pol, count);
 				}
 
-				pglVertexPointer(3, GL_FLOAT, 0, vertBuffer);
-				pglNormalPointer(GL_FLOAT, 0, normBuffer);
+				pglVertexPointer(3, GL_FLOAT, 0, pose->vertices);
+				pglNormalPointer(GL_FLOAT, 0, pose->normals);
 				pglTexCoordPointer(2, GL_FLOAT, 0, mesh->uvs);
 				pglDrawArrays(GL_TRIANGLES, 0, mesh->numVertices);
 			}
@@ -104,6 +104,8 @@ static patch_t *crosshair[HU_CROSSHAIRS]; // 3 precached crosshair graphics
 // protos.
 // -------
 static void HU_DrawRankings(void);
+static inline void HU_DrawSpectatorTicker(void);
+static vlayer_t hu_rankingslayer;
 static void HU_DrawCoopOverlay(void);
 static void HU_DrawNetplayCoopOverlay(void);
 
@@ -2117,7 +2119,14 @@ void HU_Drawer(void)
 		if (netgame || multiplayer)
 		{
 			if (LUA_HudEnabled(hud_rankings))
-				HU_DrawRankings();
+			{
+				V_DrawLayer(&hu_rankingslayer, HU_DrawRankings);
+
+				// draw spectators in a ticker across the bottom
+				// (kept out of the layer, since it scrolls every tic)
+				if (!splitscreen && G_GametypeHasSpectators())
+					HU_DrawSpectatorTicker();
+			}
 			if (gametype == GT_COOP)
 				HU_DrawNetplayCoopOverlay();
 		}
@@ -3043,10 +3052,6 @@ static void HU_DrawRankings(void)
 		HU_DrawDualTabRankings(32, 32, tab, scorelines, whiteplayer);
 	else
 		HU_Draw32TabRankings(14, 28, tab, scorelines, whiteplayer);
-
-	// draw spectators in a ticker across the bottom
-	if (!splitscreen && G_GametypeHasSpectators())
-		HU_DrawSpectatorTicker();
 }
 
 static void HU_DrawCoopOverlay(void)
@@ -42,6 +42,15 @@ extern UINT8 keyboard_started;
 */
 size_t I_GetFreeMem(size_t *total);
 
+/**	\brief	Fills a buffer with cryptographically random bytes
+
+	\param	buf	buffer to fill
+	\param	len	number of bytes
+
+	\return	false if the system has no source of them
+*/
+boolean I_GetRandomBytes(void *buf, size_t len);
+
 
 /**	\brief	Returns precise time value for performance measurement. The precise
             time should be a monotonically increasing counter, and will wrap.
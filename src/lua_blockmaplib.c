@@ -31,16 +31,16 @@ typedef UINT8 (*blockmap_func)(lua_State *, INT32, INT32, mobj_t *);
 
 static boolean blockfuncerror = false; // errors should only print once per search blockmap call
 
-// Helper function for "objects" search
-static UINT8 lib_searchBlockmap_Objects(lua_State *L, INT32 x, INT32 y, mobj_t *thing)
+// Searches a single thing block (see THINGBLOCKSHIFT)
+static UINT8 lib_searchThingBlock_Objects(lua_State *L, INT32 x, INT32 y, mobj_t *thing)
 {
 	mobj_t *mobj, *bnext = NULL;
 
-	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+	if (x < 0 || y < 0 || x >= thingmapwidth || y >= thingmapheight)
 		return 0;
 
 	// Check interaction with the objects in the blockmap.
-	for (mobj = blocklinks[y*bmapwidth + x]; mobj; mobj = bnext)
+	for (mobj = blocklinks[y*thingmapwidth + x]; mobj; mobj = bnext)
 	{
 		P_SetTarget(&bnext, mobj->bnext); // We want to note our reference to bnext here incase it is MF_NOTHINK and gets removed!
 		if (mobj == thing)
@@ -73,6 +73,22 @@ static UINT8 lib_searchBlockmap_Objects(lua_State *L, INT32 x, INT32 y, mobj_t *
 	return 0;
 }
 
+// Helper function for "objects" search
+static UINT8 lib_searchBlockmap_Objects(lua_State *L, INT32 x, INT32 y, mobj_t *thing)
+{
+	INT32 bx, by;
+	UINT8 retval;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return 0;
+
+	for (by = y*THINGBLOCKS; by < (y+1)*THINGBLOCKS; by++)
+		for (bx = x*THINGBLOCKS; bx < (x+1)*THINGBLOCKS; bx++)
+			if ((retval = lib_searchThingBlock_Objects(L, bx, by, thing)) != 0)
+				return retval; // 1 still stops this whole mapblock
+	return 0;
+}
+
 // Helper function for "lines" search
 static UINT8 lib_searchBlockmap_Lines(lua_State *L, INT32 x, INT32 y, mobj_t *thing)
 {
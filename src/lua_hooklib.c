@@ -18,6 +18,9 @@
 #include "b_bot.h"
 #include "z_zone.h"
 #include "m_perfstats.h"
+#include "d_netcmd.h"
+#include "d_main.h" // srb2home
+#include "i_system.h"
 
 #include "lua_script.h"
 #include "lua_libs.h"
@@ -66,42 +69,35 @@ struct hook_s
 {
 	struct hook_s *next;
 	enum hook type;
-	UINT16 id;
+	int ref; // the hook function, as a luaL_ref into the registry
 	union {
 		mobjtype_t mt;
 		char *skinname;
 		char *funcname;
 	} s;
 	boolean error;
+	// watchdog statistics, see LUAh_WatchdogLeave
+	precise_t worst; // slowest single call
+	UINT32 calls;
+	UINT32 overruns; // outermost calls that went over budget
 };
 typedef struct hook_s* hook_p;
 
-#define FMT_HOOKID "hook_%d"
+// Mobj hooks run from hook_MobjSpawn to hook_MobjRemoved in enum hook.
+#define MOBJHOOK(type) ((type) - hook_MobjSpawn)
+#define NUMMOBJHOOKS (hook_MobjRemoved - hook_MobjSpawn + 1)
 
-// For each mobj type, a linked list to its thinker and collision hooks.
-// That way, we don't have to iterate through all the hooks.
-// We could do that with all other mobj hooks, but it would probably just be
-// a waste of memory since they are only called occasionally. Probably...
-static hook_p mobjthinkerhooks[NUMMOBJTYPES];
-static hook_p mobjcollidehooks[NUMMOBJTYPES];
+// For each mobj hook type and mobj type, a linked list of its hooks.
+// That way, dispatching never has to skip over hooks it isn't calling.
+static hook_p mobjhooks[NUMMOBJHOOKS][NUMMOBJTYPES];
 
-// For each mobj type, a linked list for other mobj hooks
-static hook_p mobjhooks[NUMMOBJTYPES];
-
-// A linked list for player hooks
-static hook_p playerhooks;
-
-// A linked list for linedef executor hooks
-static hook_p linedefexecutorhooks;
-
-// For other hooks, a unique linked list
-hook_p roothook;
+// For every other hook type, a linked list of its hooks
+static hook_p roothooks[hook_MAX];
 
 // Takes hook, function, and additional arguments (mobj type to act on, etc.)
 static int lib_addHook(lua_State *L)
 {
-	static struct hook_s hook = {NULL, 0, 0, {0}, false};
-	static UINT32 nextid;
+	static struct hook_s hook = {NULL, 0, LUA_NOREF, {0}, false, 0, 0, 0};
 	hook_p hookp, *lastp;
 
 	hook.type = luaL_checkoption(L, 1, NULL, hookNames);
@@ -164,45 +160,10 @@ static int lib_addHook(lua_State *L)
 
 	hooksAvailable[hook.type/8] |= 1<<(hook.type%8);
 
-	// set hook.id to the highest id + 1
-	hook.id = nextid++;
-
-	// Special cases for some hook types (see the comments above mobjthinkerhooks declaration)
-	switch(hook.type)
-	{
-	case hook_MobjThinker:
-		lastp = &mobjthinkerhooks[hook.s.mt];
-		break;
-	case hook_MobjCollide:
-	case hook_MobjMoveCollide:
-		lastp = &mobjcollidehooks[hook.s.mt];
-		break;
-	case hook_MobjSpawn:
-	case hook_TouchSpecial:
-	case hook_MobjFuse:
-	case hook_BossThinker:
-	case hook_ShouldDamage:
-	case hook_MobjDamage:
-	case hook_MobjDeath:
-	case hook_BossDeath:
-	case hook_MobjRemoved:
-		lastp = &mobjhooks[hook.s.mt];
-		break;
-	case hook_JumpSpecial:
-	case hook_AbilitySpecial:
-	case hook_SpinSpecial:
-	case hook_JumpSpinSpecial:
-	case hook_PlayerSpawn:
-	case hook_PlayerThink:
-		lastp = &playerhooks;
-		break;
-	case hook_LinedefExecute:
-		lastp = &linedefexecutorhooks;
-		break;
-	default:
-		lastp = &roothook;
-		break;
-	}
+	if (hook.type >= hook_MobjSpawn && hook.type <= hook_MobjRemoved)
+		lastp = &mobjhooks[MOBJHOOK(hook.type)][hook.s.mt];
+	else
+		lastp = &roothooks[hook.type];
 
 	// iterate the hook metadata structs
 	// set lastp to the last hook struct's "next" pointer.
@@ -214,17 +175,197 @@ static int lib_addHook(lua_State *L)
 	// tack it onto the end of the linked list.
 	*lastp = hookp;
 
-	// set the hook function in the registry.
-	lua_pushfstring(L, FMT_HOOKID, hook.id);
-	lua_pushvalue(L, 1);
-	lua_settable(L, LUA_REGISTRYINDEX);
+	// keep the hook function in the registry, referenced by an integer
+	// so calling it is a single rawgeti.
+	hookp->ref = luaL_ref(L, LUA_REGISTRYINDEX);
 	return 0;
 }
 
+// Hook watchdog
+// Every hook call is timed, and a count hook ticks every LUAWATCHDOGSTEP
+// VM instructions so a runaway hook can be stopped from inside. Hooks that
+// call into the game can run other hooks; the budget covers the outermost
+// call, nested ones only add to their own statistics.
+#define LUAWATCHDOGSTEP 1000
+
+static struct
+{
+	INT32 depth; // nested hook calls in progress
+	precise_t start; // when the outermost call began
+	UINT32 steps; // count hook ticks since then
+	boolean aborted;
+} watchdog;
+
+static precise_t LUAh_WatchdogTimeLimit(void)
+{
+	return (precise_t)cv_lua_hooktimelimit.value * I_GetPrecisePrecision() / 1000;
+}
+
+static boolean LUAh_WatchdogOverInstructions(void)
+{
+	return (cv_lua_hookinstrlimit.value
+		&& watchdog.steps >= (UINT32)max(cv_lua_hookinstrlimit.value / LUAWATCHDOGSTEP, 1));
+}
+
+static void LUAh_WatchdogCount(lua_State *L, lua_Debug *ar);
+
+// Once aborted, the count hook fires on every instruction and keeps raising
+// errors, so a hook can't pcall its way past the abort.
+static void LUAh_WatchdogAbort(lua_State *L, const char *fmt, INT32 limit)
+{
+	if (!watchdog.aborted)
+	{
+		watchdog.aborted = true;
+		lua_sethook(gL, LUAh_WatchdogCount, LUA_MASKCOUNT, 1);
+		if (L != gL)
+			lua_sethook(L, LUAh_WatchdogCount, LUA_MASKCOUNT, 1);
+	}
+	luaL_error(L, fmt, limit);
+}
+
+static void LUAh_WatchdogCount(lua_State *L, lua_Debug *ar)
+{
+	(void)ar;
+
+	// Coroutines created during a hook inherit the count hook
+	if (!watchdog.depth)
+	{
+		lua_sethook(L, NULL, 0, 0);
+		return;
+	}
+
+	if (watchdog.aborted)
+		LUAh_WatchdogAbort(L, "hook was aborted by the watchdog", 0);
+
+	watchdog.steps++;
+
+	if (cv_lua_hookwatchdog.value != 2)
+		return;
+
+	// Instruction counts are the same on every machine, so this budget is
+	// safe to enforce in netgames. Wall time is not; it only aborts offline.
+	if (LUAh_WatchdogOverInstructions())
+		LUAh_WatchdogAbort(L, "hook exceeded the instruction budget of %d", cv_lua_hookinstrlimit.value);
+	if (cv_lua_hooktimelimit.value && !netgame
+		&& I_GetPreciseTime() - watchdog.start > LUAh_WatchdogTimeLimit())
+		LUAh_WatchdogAbort(L, "hook exceeded the time budget of %d ms", cv_lua_hooktimelimit.value);
+}
+
+static precise_t LUAh_WatchdogEnter(void)
+{
+	const precise_t now = I_GetPreciseTime();
+
+	if (watchdog.depth++ == 0)
+	{
+		watchdog.start = now;
+		watchdog.steps = 0;
+		watchdog.aborted = false;
+		lua_sethook(gL, LUAh_WatchdogCount, LUA_MASKCOUNT, LUAWATCHDOGSTEP);
+	}
+	return now;
+}
+
+// Appends an overrun to luawatchdog.csv in srb2home: the tic, the hook
+// type, func (the function's "file:line"), how long it ran for, how many
+// instructions it got through and whether it was aborted.
+static void LUAh_WatchdogLog(hook_p hookp, const char *func, UINT32 us)
+{
+	char path[256+32];
+	FILE *f;
+
+	snprintf(path, sizeof path, "%s"PATHSEP"%s", srb2home, "luawatchdog.csv");
+	f = fopen(path, "a");
+	if (!f)
+		return;
+
+	fseek(f, 0, SEEK_END);
+	if (ftell(f) == 0)
+		fprintf(f, "tic,hook,function,time_us,instructions,action\n");
+	fprintf(f, "%u,%s,%s,%u,%lu,%s\n", gametic, hookNames[hookp->type], func, us,
+		(unsigned long)watchdog.steps * LUAWATCHDOGSTEP, watchdog.aborted ? "abort" : "warn");
+	fclose(f);
+}
+
+static void LUAh_WatchdogLeave(hook_p hookp, precise_t start)
+{
+	const precise_t total = I_GetPreciseTime() - start;
+	const boolean newworst = (total > hookp->worst);
+	lua_Debug ar;
+	char func[64];
+	UINT32 us;
+
+	hookp->calls++;
+	if (newworst)
+		hookp->worst = total;
+
+	if (--watchdog.depth)
+		return;
+	lua_sethook(gL, NULL, 0, 0);
+
+	if (!watchdog.aborted
+		&& !(cv_lua_hooktimelimit.value && total > LUAh_WatchdogTimeLimit())
+		&& !LUAh_WatchdogOverInstructions())
+		return;
+
+	// Report the first overrun of each hook and any that beat its record;
+	// a hook that is always slow would otherwise flood the console and log.
+	if (++hookp->overruns > 1 && !newworst && !(cv_debug & DBG_LUA))
+		return;
+
+	us = (UINT32)(total * 1000000 / I_GetPrecisePrecision());
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+	lua_getinfo(gL, ">S", &ar); // pops the function
+	snprintf(func, sizeof func, "%s:%d", ar.short_src, ar.linedefined);
+
+	if (hookp->overruns == 1 || cv_debug & DBG_LUA)
+		CONS_Alert(CONS_WARNING, M_GetText("%s hook %s %s after %u us and %lu instructions\n"),
+			hookNames[hookp->type], func, watchdog.aborted ? "was aborted" : "ran over budget",
+			us, (unsigned long)watchdog.steps * LUAWATCHDOGSTEP);
+	LUAh_WatchdogLog(hookp, func, us);
+}
+
+// Calls a hook function that is below its nargs arguments on the stack,
+// timing it if the Lua profiler or the watchdog is running.
+static int LUAh_PCall(hook_p hookp, int nargs, int nresults)
+{
+	const boolean profiled = ps_luaprof_active;
+	const boolean watched = (cv_lua_hookwatchdog.value != 0);
+	ps_luaprofcall_t prof;
+	precise_t start = 0;
+	int err;
+
+	if (!profiled && !watched)
+		return lua_pcall(gL, nargs, nresults, 0);
+
+	if (watched)
+		start = LUAh_WatchdogEnter();
+	if (profiled)
+		PS_LuaProfEnter(&prof);
+	err = lua_pcall(gL, nargs, nresults, 0);
+	if (profiled)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		PS_LuaProfLeave(&prof, gL, hookNames[hookp->type]);
+	}
+	if (watched)
+		LUAh_WatchdogLeave(hookp, start);
+	return err;
+}
+
+// LUA_Call for hooks
+#define LUAh_Call(hookp, nargs)\
+{\
+	if (LUAh_PCall(hookp, nargs, 0)) {\
+		CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL,-1));\
+		lua_pop(gL, 1);\
+	}\
+}
+
 int LUA_HookLib(lua_State *L)
 {
 	memset(hooksAvailable,0,sizeof(UINT8[(hook_MAX/8)+1]));
-	roothook = NULL;
+	memset(mobjhooks,0,sizeof(mobjhooks));
+	memset(roothooks,0,sizeof(roothooks));
 	lua_register(L, "addHook", lib_addHook);
 	return 0;
 }
@@ -241,47 +382,43 @@ boolean LUAh_MobjHook(mobj_t *mo, enum hook which)
 	lua_settop(gL, 0);
 
 	// Look for all generic mobj hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, mo, META_MOBJ);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+	for (hookp = mobjhooks[MOBJHOOK(which)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
+			LUA_PushUserdata(gL, mo, META_MOBJ);
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		if (LUAh_PCall(hookp, 1, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjhooks[mo->type]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, mo, META_MOBJ);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+	for (hookp = mobjhooks[MOBJHOOK(which)][mo->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
+			LUA_PushUserdata(gL, mo, META_MOBJ);
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		if (LUAh_PCall(hookp, 1, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -296,26 +433,24 @@ boolean LUAh_PlayerHook(player_t *plr, enum hook which)
 
 	lua_settop(gL, 0);
 
-	for (hookp = playerhooks; hookp; hookp = hookp->next)
-		if (hookp->type == which)
-		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-				LUA_PushUserdata(gL, plr, META_PLAYER);
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			if (lua_pcall(gL, 1, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+	for (hookp = roothooks[which]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
+			LUA_PushUserdata(gL, plr, META_PLAYER);
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		if (LUAh_PCall(hookp, 1, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -331,14 +466,12 @@ void LUAh_MapChange(INT16 mapnumber)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, mapnumber);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MapChange)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_MapChange]; hookp; hookp = hookp->next)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		LUAh_Call(hookp, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -353,14 +486,12 @@ void LUAh_MapLoad(void)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, gamemap);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MapLoad)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_MapLoad]; hookp; hookp = hookp->next)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		LUAh_Call(hookp, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -375,14 +506,12 @@ void LUAh_PlayerJoin(int playernum)
 	lua_settop(gL, 0);
 	lua_pushinteger(gL, playernum);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerJoin)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2);
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_PlayerJoin]; hookp; hookp = hookp->next)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2);
+		LUAh_Call(hookp, 1);
+	}
 
 	lua_settop(gL, 0);
 }
@@ -394,14 +523,10 @@ void LUAh_PreThinkFrame(void)
 	if (!gL || !(hooksAvailable[hook_PreThinkFrame/8] & (1<<(hook_PreThinkFrame%8))))
 		return;
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	for (hookp = roothooks[hook_PreThinkFrame]; hookp; hookp = hookp->next)
 	{
-		if (hookp->type != hook_PreThinkFrame)
-			continue;
-
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
-		if (lua_pcall(gL, 0, 0, 0)) {
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		if (LUAh_PCall(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -420,31 +545,28 @@ void LUAh_ThinkFrame(void)
 	if (!gL || !(hooksAvailable[hook_ThinkFrame/8] & (1<<(hook_ThinkFrame%8))))
 		return;
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ThinkFrame)
+	for (hookp = roothooks[hook_ThinkFrame]; hookp; hookp = hookp->next)
+	{
+		if (cv_perfstats.value == 3)
+			time_taken = I_GetPreciseTime();
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		if (LUAh_PCall(hookp, 0, 0)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
+			lua_pop(gL, 1);
+			hookp->error = true;
+		}
+		if (cv_perfstats.value == 3)
 		{
-			if (cv_perfstats.value == 3)
-				time_taken = I_GetPreciseTime();
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			if (lua_pcall(gL, 0, 0, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-			}
-			if (cv_perfstats.value == 3)
-			{
-				lua_Debug ar;
-				time_taken = I_GetPreciseTime() - time_taken;
-				// we need the function, let's just retrieve it again
-				lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-				lua_gettable(gL, LUA_REGISTRYINDEX);
-				lua_getinfo(gL, ">S", &ar);
-				PS_SetThinkFrameHookInfo(hook_index, time_taken, ar.short_src);
-				hook_index++;
-			}
+			lua_Debug ar;
+			time_taken = I_GetPreciseTime() - time_taken;
+			// we need the function, let's just retrieve it again
+			lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+			lua_getinfo(gL, ">S", &ar);
+			PS_SetThinkFrameHookInfo(hook_index, time_taken, ar.short_src);
+			hook_index++;
 		}
+	}
 }
 
 
@@ -455,14 +577,10 @@ void LUAh_PostThinkFrame(void)
 	if (!gL || !(hooksAvailable[hook_PostThinkFrame/8] & (1<<(hook_PostThinkFrame%8))))
 		return;
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
+	for (hookp = roothooks[hook_PostThinkFrame]; hookp; hookp = hookp->next)
 	{
-		if (hookp->type != hook_PostThinkFrame)
-			continue;
-
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
-		if (lua_pcall(gL, 0, 0, 0)) {
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		if (LUAh_PCall(hookp, 0, 0)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -484,71 +602,77 @@ UINT8 LUAh_MobjCollideHook(mobj_t *thing1, mobj_t *thing2, enum hook which)
 	lua_settop(gL, 0);
 
 	// Look for all generic mobj collision hooks
-	for (hookp = mobjcollidehooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
+	for (hookp = mobjhooks[MOBJHOOK(which)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, thing1, META_MOBJ);
-				LUA_PushUserdata(gL, thing2, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{ // if nil, leave shouldCollide = 0.
-				if (lua_toboolean(gL, -1))
-					shouldCollide = 1; // Force yes
-				else
-					shouldCollide = 2; // Force no
-			}
+			LUA_PushUserdata(gL, thing1, META_MOBJ);
+			LUA_PushUserdata(gL, thing2, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		if (LUAh_PCall(hookp, 2, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
+		}
+		if (!lua_isnil(gL, -1))
+		{ // if nil, leave shouldCollide = 0.
+			if (lua_toboolean(gL, -1))
+				shouldCollide = 1; // Force yes
+			else
+				shouldCollide = 2; // Force no
 		}
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjcollidehooks[thing1->type]; hookp; hookp = hookp->next)
-		if (hookp->type == which)
+	for (hookp = mobjhooks[MOBJHOOK(which)][thing1->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, thing1, META_MOBJ);
-				LUA_PushUserdata(gL, thing2, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{ // if nil, leave shouldCollide = 0.
-				if (lua_toboolean(gL, -1))
-					shouldCollide = 1; // Force yes
-				else
-					shouldCollide = 2; // Force no
-			}
+			LUA_PushUserdata(gL, thing1, META_MOBJ);
+			LUA_PushUserdata(gL, thing2, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		if (LUAh_PCall(hookp, 2, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
+		}
+		if (!lua_isnil(gL, -1))
+		{ // if nil, leave shouldCollide = 0.
+			if (lua_toboolean(gL, -1))
+				shouldCollide = 1; // Force yes
+			else
+				shouldCollide = 2; // Force no
 		}
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return shouldCollide;
 }
 
 // Hook for mobj thinkers
+boolean LUAh_MobjThinkerAvailable(mobjtype_t type)
+{
+	if (!gL || !(hooksAvailable[hook_MobjThinker/8] & (1<<(hook_MobjThinker%8))))
+		return false;
+
+	I_Assert(type < NUMMOBJTYPES);
+
+	return (mobjhooks[MOBJHOOK(hook_MobjThinker)][MT_NULL] || mobjhooks[MOBJHOOK(hook_MobjThinker)][type]);
+}
+
 boolean LUAh_MobjThinker(mobj_t *mo)
 {
 	hook_p hookp;
@@ -561,14 +685,13 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 	lua_settop(gL, 0);
 
 	// Look for all generic mobj thinker hooks
-	for (hookp = mobjthinkerhooks[MT_NULL]; hookp; hookp = hookp->next)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjThinker)][MT_NULL]; hookp; hookp = hookp->next)
 	{
 		if (lua_gettop(gL) == 0)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 0)) {
+		if (LUAh_PCall(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -580,14 +703,13 @@ boolean LUAh_MobjThinker(mobj_t *mo)
 		lua_pop(gL, 1);
 	}
 
-	for (hookp = mobjthinkerhooks[mo->type]; hookp; hookp = hookp->next)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjThinker)][mo->type]; hookp; hookp = hookp->next)
 	{
 		if (lua_gettop(gL) == 0)
 			LUA_PushUserdata(gL, mo, META_MOBJ);
-		lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-		lua_gettable(gL, LUA_REGISTRYINDEX);
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
 		lua_pushvalue(gL, -2);
-		if (lua_pcall(gL, 1, 1, 0)) {
+		if (LUAh_PCall(hookp, 1, 1)) {
 			if (!hookp->error || cv_debug & DBG_LUA)
 				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
@@ -616,55 +738,51 @@ boolean LUAh_TouchSpecial(mobj_t *special, mobj_t *toucher)
 	lua_settop(gL, 0);
 
 	// Look for all generic touch special hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_TouchSpecial)
+	for (hookp = mobjhooks[MOBJHOOK(hook_TouchSpecial)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, special, META_MOBJ);
-				LUA_PushUserdata(gL, toucher, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, special, META_MOBJ);
+			LUA_PushUserdata(gL, toucher, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		if (LUAh_PCall(hookp, 2, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjhooks[special->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_TouchSpecial)
+	for (hookp = mobjhooks[MOBJHOOK(hook_TouchSpecial)][special->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, special, META_MOBJ);
-				LUA_PushUserdata(gL, toucher, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, special, META_MOBJ);
+			LUA_PushUserdata(gL, toucher, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		if (LUAh_PCall(hookp, 2, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -683,73 +801,69 @@ UINT8 LUAh_ShouldDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 	lua_settop(gL, 0);
 
 	// Look for all generic should damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ShouldDamage)
+	for (hookp = mobjhooks[MOBJHOOK(hook_ShouldDamage)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{
-				if (lua_toboolean(gL, -1))
-					shouldDamage = 1; // Force yes
-				else
-					shouldDamage = 2; // Force no
-			}
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+			lua_pushinteger(gL, damage);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		if (LUAh_PCall(hookp, 4, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (!lua_isnil(gL, -1))
+		{
+			if (lua_toboolean(gL, -1))
+				shouldDamage = 1; // Force yes
+			else
+				shouldDamage = 2; // Force no
+		}
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_ShouldDamage)
+	for (hookp = mobjhooks[MOBJHOOK(hook_ShouldDamage)][target->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (!lua_isnil(gL, -1))
-			{
-				if (lua_toboolean(gL, -1))
-					shouldDamage = 1; // Force yes
-				else
-					shouldDamage = 2; // Force no
-			}
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+			lua_pushinteger(gL, damage);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		if (LUAh_PCall(hookp, 4, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (!lua_isnil(gL, -1))
+		{
+			if (lua_toboolean(gL, -1))
+				shouldDamage = 1; // Force yes
+			else
+				shouldDamage = 2; // Force no
+		}
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return shouldDamage;
@@ -768,63 +882,59 @@ boolean LUAh_MobjDamage(mobj_t *target, mobj_t *inflictor, mobj_t *source, INT32
 	lua_settop(gL, 0);
 
 	// Look for all generic mobj damage hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDamage)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjDamage)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+			lua_pushinteger(gL, damage);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		if (LUAh_PCall(hookp, 4, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDamage)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjDamage)][target->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-				lua_pushinteger(gL, damage);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+			lua_pushinteger(gL, damage);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		if (LUAh_PCall(hookp, 4, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -843,59 +953,55 @@ boolean LUAh_MobjDeath(mobj_t *target, mobj_t *inflictor, mobj_t *source)
 	lua_settop(gL, 0);
 
 	// Look for all generic mobj death hooks
-	for (hookp = mobjhooks[MT_NULL]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDeath)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjDeath)][MT_NULL]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -4);
+		lua_pushvalue(gL, -4);
+		lua_pushvalue(gL, -4);
+		if (LUAh_PCall(hookp, 3, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
-	for (hookp = mobjhooks[target->type]; hookp; hookp = hookp->next)
-		if (hookp->type == hook_MobjDeath)
+	for (hookp = mobjhooks[MOBJHOOK(hook_MobjDeath)][target->type]; hookp; hookp = hookp->next)
+	{
+		ps_lua_mobjhooks.value.i++;
+		if (lua_gettop(gL) == 0)
 		{
-			ps_lua_mobjhooks.value.i++;
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, target, META_MOBJ);
-				LUA_PushUserdata(gL, inflictor, META_MOBJ);
-				LUA_PushUserdata(gL, source, META_MOBJ);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, target, META_MOBJ);
+			LUA_PushUserdata(gL, inflictor, META_MOBJ);
+			LUA_PushUserdata(gL, source, META_MOBJ);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -4);
+		lua_pushvalue(gL, -4);
+		lua_pushvalue(gL, -4);
+		if (LUAh_PCall(hookp, 3, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -911,29 +1017,27 @@ boolean LUAh_BotTiccmd(player_t *bot, ticcmd_t *cmd)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_BotTiccmd)
+	for (hookp = roothooks[hook_BotTiccmd]; hookp; hookp = hookp->next)
+	{
+		if (lua_gettop(gL) == 0)
 		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, bot, META_PLAYER);
-				LUA_PushUserdata(gL, cmd, META_TICCMD);
-			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			LUA_PushUserdata(gL, bot, META_PLAYER);
+			LUA_PushUserdata(gL, cmd, META_TICCMD);
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		if (LUAh_PCall(hookp, 2, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -949,20 +1053,18 @@ boolean LUAh_BotAI(mobj_t *sonic, mobj_t *tails, ticcmd_t *cmd)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_BotAI
-		&& (hookp->s.skinname == NULL || !strcmp(hookp->s.skinname, ((skin_t*)tails->skin)->name)))
+	for (hookp = roothooks[hook_BotAI]; hookp; hookp = hookp->next)
+		if (hookp->s.skinname == NULL || !strcmp(hookp->s.skinname, ((skin_t*)tails->skin)->name))
 		{
 			if (lua_gettop(gL) == 0)
 			{
 				LUA_PushUserdata(gL, sonic, META_MOBJ);
 				LUA_PushUserdata(gL, tails, META_MOBJ);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
+			lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
 			lua_pushvalue(gL, -3);
 			lua_pushvalue(gL, -3);
-			if (lua_pcall(gL, 2, 8, 0)) {
+			if (LUAh_PCall(hookp, 2, 8)) {
 				if (!hookp->error || cv_debug & DBG_LUA)
 					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 				lua_pop(gL, 1);
@@ -1010,7 +1112,7 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 
 	lua_settop(gL, 0);
 
-	for (hookp = linedefexecutorhooks; hookp; hookp = hookp->next)
+	for (hookp = roothooks[hook_LinedefExecute]; hookp; hookp = hookp->next)
 		if (!strcmp(hookp->s.funcname, line->text))
 		{
 			ps_lua_mobjhooks.value.i++;
@@ -1020,12 +1122,11 @@ boolean LUAh_LinedefExecute(line_t *line, mobj_t *mo, sector_t *sector)
 				LUA_PushUserdata(gL, mo, META_MOBJ);
 				LUA_PushUserdata(gL, sector, META_SECTOR);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
+			lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
-			LUA_Call(gL, 3);
+			LUAh_Call(hookp, 3);
 			hooked = true;
 		}
 
@@ -1043,44 +1144,42 @@ boolean LUAh_PlayerMsg(int source, int target, int flags, char *msg)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerMsg)
+	for (hookp = roothooks[hook_PlayerMsg]; hookp; hookp = hookp->next)
+	{
+		if (lua_gettop(gL) == 0)
 		{
-			if (lua_gettop(gL) == 0)
-			{
-				LUA_PushUserdata(gL, &players[source], META_PLAYER); // Source player
-				if (flags & 2 /*HU_CSAY*/) { // csay TODO: make HU_CSAY accessible outside hu_stuff.c
-					lua_pushinteger(gL, 3); // type
-					lua_pushnil(gL); // target
-				} else if (target == -1) { // sayteam
-					lua_pushinteger(gL, 1); // type
-					lua_pushnil(gL); // target
-				} else if (target == 0) { // say
-					lua_pushinteger(gL, 0); // type
-					lua_pushnil(gL); // target
-				} else { // sayto
-					lua_pushinteger(gL, 2); // type
-					LUA_PushUserdata(gL, &players[target-1], META_PLAYER); // target
-				}
-				lua_pushstring(gL, msg); // msg
+			LUA_PushUserdata(gL, &players[source], META_PLAYER); // Source player
+			if (flags & 2 /*HU_CSAY*/) { // csay TODO: make HU_CSAY accessible outside hu_stuff.c
+				lua_pushinteger(gL, 3); // type
+				lua_pushnil(gL); // target
+			} else if (target == -1) { // sayteam
+				lua_pushinteger(gL, 1); // type
+				lua_pushnil(gL); // target
+			} else if (target == 0) { // say
+				lua_pushinteger(gL, 0); // type
+				lua_pushnil(gL); // target
+			} else { // sayto
+				lua_pushinteger(gL, 2); // type
+				LUA_PushUserdata(gL, &players[target-1], META_PLAYER); // target
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			lua_pushvalue(gL, -5);
-			if (lua_pcall(gL, 4, 1, 0)) {
-				if (!hookp->error || cv_debug & DBG_LUA)
-					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
-				lua_pop(gL, 1);
-				hookp->error = true;
-				continue;
-			}
-			if (lua_toboolean(gL, -1))
-				hooked = true;
+			lua_pushstring(gL, msg); // msg
+		}
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		lua_pushvalue(gL, -5);
+		if (LUAh_PCall(hookp, 4, 1)) {
+			if (!hookp->error || cv_debug & DBG_LUA)
+				CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 			lua_pop(gL, 1);
+			hookp->error = true;
+			continue;
 		}
+		if (lua_toboolean(gL, -1))
+			hooked = true;
+		lua_pop(gL, 1);
+	}
 
 	lua_settop(gL, 0);
 	return hooked;
@@ -1097,9 +1196,8 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_HurtMsg
-		&& (hookp->s.mt == MT_NULL || (inflictor && hookp->s.mt == inflictor->type)))
+	for (hookp = roothooks[hook_HurtMsg]; hookp; hookp = hookp->next)
+		if (hookp->s.mt == MT_NULL || (inflictor && hookp->s.mt == inflictor->type))
 		{
 			if (lua_gettop(gL) == 0)
 			{
@@ -1107,12 +1205,11 @@ boolean LUAh_HurtMsg(player_t *player, mobj_t *inflictor, mobj_t *source)
 				LUA_PushUserdata(gL, inflictor, META_MOBJ);
 				LUA_PushUserdata(gL, source, META_MOBJ);
 			}
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
+			lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
 			lua_pushvalue(gL, -4);
-			if (lua_pcall(gL, 3, 1, 0)) {
+			if (LUAh_PCall(hookp, 3, 1)) {
 				if (!hookp->error || cv_debug & DBG_LUA)
 					CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL, -1));
 				lua_pop(gL, 1);
@@ -1144,14 +1241,12 @@ void LUAh_NetArchiveHook(lua_CFunction archFunc)
 	lua_pushcclosure(gL, archFunc, 1);
 	// stack: tables, archFunc
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_NetVars)
-		{
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -2); // archFunc
-			LUA_Call(gL, 1);
-		}
+	for (hookp = roothooks[hook_NetVars]; hookp; hookp = hookp->next)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -2); // archFunc
+		LUAh_Call(hookp, 1);
+	}
 
 	lua_pop(gL, 1); // pop archFunc
 	// stack: tables
@@ -1165,20 +1260,123 @@ void LUAh_PlayerQuit(player_t *plr, int reason)
 
 	lua_settop(gL, 0);
 
-	for (hookp = roothook; hookp; hookp = hookp->next)
-		if (hookp->type == hook_PlayerQuit)
+	for (hookp = roothooks[hook_PlayerQuit]; hookp; hookp = hookp->next)
+	{
+	    if (lua_gettop(gL) == 0)
+	    {
+	        LUA_PushUserdata(gL, plr, META_PLAYER); // Player that quit
+	        lua_pushinteger(gL, reason); // Reason for quitting
+	    }
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_pushvalue(gL, -3);
+		lua_pushvalue(gL, -3);
+		LUAh_Call(hookp, 2);
+	}
+
+	lua_settop(gL, 0);
+}
+
+static void LUAh_PrintHookStats(hook_p hookp, boolean reset)
+{
+	lua_Debug ar;
+
+	for (; hookp; hookp = hookp->next)
+	{
+		if (reset)
 		{
-		    if (lua_gettop(gL) == 0)
-		    {
-		        LUA_PushUserdata(gL, plr, META_PLAYER); // Player that quit
-		        lua_pushinteger(gL, reason); // Reason for quitting
-		    }
-			lua_pushfstring(gL, FMT_HOOKID, hookp->id);
-			lua_gettable(gL, LUA_REGISTRYINDEX);
-			lua_pushvalue(gL, -3);
-			lua_pushvalue(gL, -3);
-			LUA_Call(gL, 2);
+			hookp->worst = 0;
+			hookp->calls = hookp->overruns = 0;
+			continue;
 		}
+		if (!hookp->calls)
+			continue;
+
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, hookp->ref);
+		lua_getinfo(gL, ">S", &ar); // pops the function
+		CONS_Printf("%-16s %s:%d: %u calls, worst %s us, %u over budget\n",
+			hookNames[hookp->type], ar.short_src, ar.linedefined, hookp->calls,
+			sizeu1((size_t)(hookp->worst * 1000000 / I_GetPrecisePrecision())), hookp->overruns);
+	}
+}
+
+// Lists the per-hook worst case times the watchdog has recorded
+void Command_LuaHookStats_f(void)
+{
+	const boolean reset = (COM_Argc() > 1 && !stricmp(COM_Argv(1), "reset"));
+	INT32 i, j;
+
+	if (!gL)
+	{
+		CONS_Printf(M_GetText("Lua is not running.\n"));
+		return;
+	}
+	if (!cv_lua_hookwatchdog.value && !reset)
+		CONS_Printf(M_GetText("The hook watchdog is off, set lua_hookwatchdog to record hook times.\n"));
+
+	for (i = 0; i < hook_MAX; i++)
+		LUAh_PrintHookStats(roothooks[i], reset);
+	for (i = 0; i < NUMMOBJHOOKS; i++)
+		for (j = 0; j < NUMMOBJTYPES; j++)
+			LUAh_PrintHookStats(mobjhooks[i][j], reset);
+}
+
+#ifdef DEVELOP
+// Times hook dispatch against an empty Lua function, comparing the old
+// string-keyed registry lookup with the luaL_ref lookup hooks use now.
+void Command_LuaHookBench_f(void)
+{
+	INT32 i, calls = 100000;
+	precise_t start, bytime, byref;
+	int ref;
+
+	if (!gL)
+	{
+		CONS_Printf(M_GetText("Lua is not running.\n"));
+		return;
+	}
+	if (COM_Argc() > 1)
+		calls = max(atoi(COM_Argv(1)), 1);
 
 	lua_settop(gL, 0);
+	if (luaL_loadstring(gL, "local mo = ... return false"))
+	{
+		lua_pop(gL, 1);
+		return;
+	}
+	lua_pushvalue(gL, 1);
+	lua_setfield(gL, LUA_REGISTRYINDEX, "hook_0");
+	ref = luaL_ref(gL, LUA_REGISTRYINDEX);
+	lua_pushnil(gL); // stands in for the mobj argument
+
+	start = I_GetPreciseTime();
+	for (i = 0; i < calls; i++)
+	{
+		lua_pushfstring(gL, "hook_%d", 0);
+		lua_gettable(gL, LUA_REGISTRYINDEX);
+		lua_pushvalue(gL, -2);
+		lua_pcall(gL, 1, 1, 0);
+		lua_pop(gL, 1);
+	}
+	bytime = I_GetPreciseTime() - start;
+
+	start = I_GetPreciseTime();
+	for (i = 0; i < calls; i++)
+	{
+		lua_rawgeti(gL, LUA_REGISTRYINDEX, ref);
+		lua_pushvalue(gL, -2);
+		lua_pcall(gL, 1, 1, 0);
+		lua_pop(gL, 1);
+	}
+	byref = I_GetPreciseTime() - start;
+
+	luaL_unref(gL, LUA_REGISTRYINDEX, ref);
+	lua_pushnil(gL);
+	lua_setfield(gL, LUA_REGISTRYINDEX, "hook_0");
+	lua_settop(gL, 0);
+
+	// nanoseconds per call
+	CONS_Printf("%d calls: string key %d ns/call, luaL_ref %d ns/call\n", calls,
+		(int)(bytime * 1000000000 / I_GetPrecisePrecision() / calls),
+		(int)(byref * 1000000000 / I_GetPrecisePrecision() / calls));
 }
+#endif
@@ -925,10 +925,19 @@ void LUAh_GameHUD(player_t *stplayr)
 
 	lua_pushnil(gL);
 	while (lua_next(gL, -5) != 0) {
+		ps_luaprofcall_t prof;
 		lua_pushvalue(gL, -5); // graphics library (HUD[1])
 		lua_pushvalue(gL, -5); // stplayr
 		lua_pushvalue(gL, -5); // camera
+		if (ps_luaprof_active)
+			PS_LuaProfEnter(&prof);
 		LUA_Call(gL, 3);
+		if (ps_luaprof_active)
+		{
+			lua_pushvalue(gL, -1); // fetch the function again for the profiler
+			lua_rawget(gL, -6);
+			PS_LuaProfLeave(&prof, gL, "GameHUD");
+		}
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
@@ -952,8 +961,17 @@ void LUAh_ScoresHUD(void)
 	lua_remove(gL, -3); // pop HUD
 	lua_pushnil(gL);
 	while (lua_next(gL, -3) != 0) {
+		ps_luaprofcall_t prof;
 		lua_pushvalue(gL, -3); // graphics library (HUD[1])
+		if (ps_luaprof_active)
+			PS_LuaProfEnter(&prof);
 		LUA_Call(gL, 1);
+		if (ps_luaprof_active)
+		{
+			lua_pushvalue(gL, -1); // fetch the function again for the profiler
+			lua_rawget(gL, -4);
+			PS_LuaProfLeave(&prof, gL, "ScoresHUD");
+		}
 	}
 	lua_pop(gL, -1);
 	hud_running = false;
@@ -270,6 +270,22 @@ boolean LUA_SetLuaAction(void *stv, const char *action)
 	return true; // action successfully set.
 }
 
+// Is this hardcoded action replaced by a Lua function?
+// action is assumed to be in all-caps already.
+boolean LUA_HasAction(const char *action)
+{
+	boolean found;
+
+	if (!gL) // Lua isn't loaded,
+		return false; // nothing to replace it with.
+
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_ACTIONS);
+	lua_getfield(gL, -1, action);
+	found = !lua_isnil(gL, -1);
+	lua_pop(gL, 2); // pop the function (or nil) and LREG_ACTIONS
+	return found;
+}
+
 boolean LUA_CallAction(const char *csaction, mobj_t *actor)
 {
 	I_Assert(csaction != NULL);
@@ -144,6 +144,7 @@ static const char *const mobj_opt[] = {
 	NULL};
 
 static int mobj_fields_ref = LUA_NOREF;
+static const void *mobj_meta = NULL; // for LUA_CheckUdata
 
 enum mapthing_e {
 	mapthing_valid,
@@ -176,7 +177,7 @@ static int mapthing_fields_ref = LUA_NOREF;
 
 static int mobj_get(lua_State *L)
 {
-	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
+	mobj_t *mo = *((mobj_t **)LUA_CheckUdata(L, 1, mobj_meta, META_MOBJ));
 	enum mobj_e field = Lua_optoption(L, 2, -1, mobj_fields_ref);
 	lua_settop(L, 2);
 
@@ -398,7 +399,7 @@ static int mobj_get(lua_State *L)
 #define NOSETPOS luaL_error(L, LUA_QL("mobj_t") " field " LUA_QS " should not be set directly. Use " LUA_QL("P_Move") ", " LUA_QL("P_TryMove") ", or " LUA_QL("P_SetOrigin") ", or " LUA_QL("P_MoveOrigin") " instead.", mobj_opt[field])
 static int mobj_set(lua_State *L)
 {
-	mobj_t *mo = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
+	mobj_t *mo = *((mobj_t **)LUA_CheckUdata(L, 1, mobj_meta, META_MOBJ));
 	enum mobj_e field = Lua_optoption(L, 2, mobj_valid, mobj_fields_ref);
 	lua_settop(L, 3);
 
@@ -564,7 +565,7 @@ static int mobj_set(lua_State *L)
 		mobjtype_t newtype = luaL_checkinteger(L, 3);
 		if (newtype >= NUMMOBJTYPES)
 			return luaL_error(L, "mobj.type %d out of range (0 - %d).", newtype, NUMMOBJTYPES-1);
-		mo->type = newtype;
+		P_SetMobjType(mo, newtype);
 		mo->info = &mobjinfo[newtype];
 		P_SetScale(mo, mo->scale);
 		break;
@@ -848,6 +849,8 @@ static int lib_nummapthings(lua_State *L)
 int LUA_MobjLib(lua_State *L)
 {
 	luaL_newmetatable(L, META_MOBJ);
+		mobj_meta = lua_topointer(L, -1);
+
 		lua_pushcfunction(L, mobj_get);
 		lua_setfield(L, -2, "__index");
 
@@ -250,6 +250,7 @@ static const char *const player_opt[] = {
 };
 
 static int player_fields_ref = LUA_NOREF;
+static const void *player_meta = NULL; // for LUA_CheckUdata
 
 enum ticcmd_e
 {
@@ -331,7 +332,7 @@ static int lib_lenPlayer(lua_State *L)
 
 static int player_get(lua_State *L)
 {
-	player_t *plr = *((player_t **)luaL_checkudata(L, 1, META_PLAYER));
+	player_t *plr = *((player_t **)LUA_CheckUdata(L, 1, player_meta, META_PLAYER));
 	enum player_e field = Lua_optoption(L, 2, -1, player_fields_ref);
 	lua_settop(L, 2);
 
@@ -704,7 +705,7 @@ static int player_get(lua_State *L)
 #define NOSET luaL_error(L, LUA_QL("player_t") " field " LUA_QS " should not be set directly.", field)
 static int player_set(lua_State *L)
 {
-	player_t *plr = *((player_t **)luaL_checkudata(L, 1, META_PLAYER));
+	player_t *plr = *((player_t **)LUA_CheckUdata(L, 1, player_meta, META_PLAYER));
 	enum player_e field = Lua_optoption(L, 2, player_cmd, player_fields_ref);
 	if (!plr)
 		return LUA_ErrInvalid(L, "player_t");
@@ -1204,6 +1205,8 @@ static int ticcmd_set(lua_State *L)
 int LUA_PlayerLib(lua_State *L)
 {
 	luaL_newmetatable(L, META_PLAYER);
+		player_meta = lua_topointer(L, -1);
+
 		lua_pushcfunction(L, player_get);
 		lua_setfield(L, -2, "__index");
 
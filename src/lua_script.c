@@ -25,6 +25,12 @@
 #ifdef LUA_ALLOW_BYTECODE
 #include "d_netfil.h" // for LUA_DumpFile
 #endif
+#include "d_netcmd.h" // cv_lua_gcbudget, cv_lua_bytecodecache
+#include "m_perfstats.h"
+#include "d_main.h" // srb2home
+#include "i_system.h" // I_mkdir, I_GetRandomBytes
+#include "md5.h"
+#include "m_argv.h" // -noluacache
 
 #include "lua_script.h"
 #include "lua_libs.h"
@@ -53,16 +59,181 @@ static lua_CFunction liblist[] = {
 	NULL
 };
 
+// Small Lua objects (strings, tables, closures, upvalues...) come from
+// pools of fixed size blocks carved out of big slabs, instead of each
+// being its own zone block. Anything bigger than the largest block size
+// still goes to the zone directly.
+// Lua always tells LUA_Alloc the old size of a block, so the pool a
+// block belongs to never has to be stored.
+
+#define LUAPOOL_SLABSIZE (32*1024)
+#define LUAPOOL_MAXSIZE 256
+#define NUMLUAPOOLS 10
+
+typedef struct luapoolblock_s
+{
+	struct luapoolblock_s *next;
+} luapoolblock_t;
+
+typedef struct luapoolslab_s
+{
+	struct luapoolslab_s *next;
+	void *pad; // so the blocks after the header stay aligned
+} luapoolslab_t;
+
+typedef struct
+{
+	size_t size;
+	luapoolblock_t *freelist;
+	size_t slabs;
+	size_t used; // blocks handed out to Lua
+} luapool_t;
+
+static luapool_t luapools[NUMLUAPOOLS] = {
+	{ 16, NULL, 0, 0}, { 32, NULL, 0, 0}, { 48, NULL, 0, 0}, { 64, NULL, 0, 0},
+	{ 80, NULL, 0, 0}, { 96, NULL, 0, 0}, {128, NULL, 0, 0}, {160, NULL, 0, 0},
+	{192, NULL, 0, 0}, {256, NULL, 0, 0}
+};
+
+// Which pool serves a size, indexed by (size+15)/16
+static const UINT8 luapoolforsize[LUAPOOL_MAXSIZE/16 + 1] = {
+	0, 0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9, 9, 9, 9
+};
+
+static luapoolslab_t *luapoolslabs = NULL;
+static size_t luabigblocks = 0, luabigbytes = 0;
+
+static void *LUA_PoolAlloc(luapool_t *pool)
+{
+	luapoolblock_t *block = pool->freelist;
+
+	if (!block)
+	{
+		// Out of blocks, thread a new slab onto the free list
+		luapoolslab_t *slab = Z_Malloc(LUAPOOL_SLABSIZE, PU_LUA, NULL);
+		UINT8 *p = (UINT8 *)slab + sizeof (luapoolslab_t);
+		UINT8 *end = (UINT8 *)slab + LUAPOOL_SLABSIZE - pool->size;
+
+		slab->next = luapoolslabs;
+		luapoolslabs = slab;
+		pool->slabs++;
+
+		for (; p <= end; p += pool->size)
+		{
+			((luapoolblock_t *)p)->next = block;
+			block = (luapoolblock_t *)p;
+		}
+	}
+
+	pool->freelist = block->next;
+	pool->used++;
+	return block;
+}
+
+static void LUA_PoolFree(luapool_t *pool, void *ptr)
+{
+	luapoolblock_t *block = ptr;
+	block->next = pool->freelist;
+	pool->freelist = block;
+	pool->used--;
+}
+
+// Frees every slab at once, for when the Lua state is gone.
+static void LUA_FreePools(void)
+{
+	size_t i;
+
+	while (luapoolslabs)
+	{
+		luapoolslab_t *next = luapoolslabs->next;
+		Z_Free(luapoolslabs);
+		luapoolslabs = next;
+	}
+
+	for (i = 0; i < NUMLUAPOOLS; i++)
+	{
+		luapools[i].freelist = NULL;
+		luapools[i].slabs = luapools[i].used = 0;
+	}
+}
+
 // Lua asks for memory using this.
 static void *LUA_Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
 {
+	luapool_t *oldpool = NULL, *newpool = NULL;
+	void *newptr;
 	(void)ud;
+
+	if (ptr && osize <= LUAPOOL_MAXSIZE)
+		oldpool = &luapools[luapoolforsize[(osize+15)/16]];
+	if (nsize && nsize <= LUAPOOL_MAXSIZE)
+		newpool = &luapools[luapoolforsize[(nsize+15)/16]];
+
 	if (nsize == 0) {
-		if (osize != 0)
+		if (oldpool)
+			LUA_PoolFree(oldpool, ptr);
+		else if (ptr) {
+			luabigblocks--;
+			luabigbytes -= osize;
 			Z_Free(ptr);
+		}
 		return NULL;
-	} else
+	}
+
+	if (oldpool == newpool && oldpool) // still fits its block
+		return ptr;
+
+	if (!oldpool && !newpool) { // big to big
+		if (ptr)
+			luabigbytes -= osize;
+		else
+			luabigblocks++;
+		luabigbytes += nsize;
 		return Z_Realloc(ptr, nsize, PU_LUA, NULL);
+	}
+
+	// moving between pools, or between a pool and the zone
+	if (newpool)
+		newptr = LUA_PoolAlloc(newpool);
+	else {
+		newptr = Z_Malloc(nsize, PU_LUA, NULL);
+		luabigblocks++;
+		luabigbytes += nsize;
+	}
+
+	if (ptr) {
+		M_Memcpy(newptr, ptr, min(osize, nsize));
+		if (oldpool)
+			LUA_PoolFree(oldpool, ptr);
+		else {
+			luabigblocks--;
+			luabigbytes -= osize;
+			Z_Free(ptr);
+		}
+	}
+
+	return newptr;
+}
+
+// Prints how much memory the Lua state uses.
+void Command_LuaMem_f(void)
+{
+	size_t i, used = 0, slabs = 0;
+
+	CONS_Printf(M_GetText("Block size   In use     Free  Slabs\n"));
+	for (i = 0; i < NUMLUAPOOLS; i++)
+	{
+		const luapool_t *pool = &luapools[i];
+		const size_t total = pool->slabs * ((LUAPOOL_SLABSIZE - sizeof (luapoolslab_t)) / pool->size);
+
+		CONS_Printf("%10s %8s %8s %6s\n", sizeu1(pool->size), sizeu2(pool->used),
+			sizeu3(total - pool->used), sizeu4(pool->slabs));
+		used += pool->used * pool->size;
+		slabs += pool->slabs;
+	}
+	CONS_Printf(M_GetText("Pooled: %s KB in use, %s KB in slabs\n"),
+		sizeu1(used / 1024), sizeu2(slabs * LUAPOOL_SLABSIZE / 1024));
+	CONS_Printf(M_GetText("Large blocks: %s, %s KB\n"), sizeu1(luabigblocks), sizeu2(luabigbytes / 1024));
 }
 
 // Panic function Lua calls when there's an unprotected error.
@@ -107,6 +278,117 @@ static int noglobals(lua_State *L)
 	return luaL_error(L, "Implicit global " LUA_QS " prevented. Create a local variable instead.", csname);
 }
 
+// Userdata handles for everything pushed with LUA_PushUserdata, found by
+// the address of the C data. Each handle is a registry reference to the
+// one userdata that stands for that address, so pushing it again is a
+// hash probe and a rawgeti, and invalidating something that never went
+// into Lua doesn't touch the Lua state at all.
+// Entries from an older generation belong to a closed Lua state and
+// count as empty slots.
+typedef struct
+{
+	void *data;
+	int ref;
+	UINT32 gen;
+} luahandle_t;
+
+static luahandle_t *luahandles = NULL;
+static size_t luahandlesize = 0; // always a power of two
+static size_t numluahandles = 0;
+static UINT32 luahandlegen = 0;
+
+#define LUAHANDLE_USED(h) ((h)->data && (h)->gen == luahandlegen)
+
+static inline size_t LUA_HandleSlot(void *data)
+{
+	size_t h = (size_t)data;
+	h ^= h >> 16;
+	h *= 0x45d9f3b;
+	h ^= h >> 16;
+	return h & (luahandlesize - 1);
+}
+
+static luahandle_t *LUA_FindHandle(void *data)
+{
+	size_t i;
+
+	if (!numluahandles)
+		return NULL;
+
+	for (i = LUA_HandleSlot(data); LUAHANDLE_USED(&luahandles[i]); i = (i + 1) & (luahandlesize - 1))
+		if (luahandles[i].data == data)
+			return &luahandles[i];
+
+	return NULL;
+}
+
+static void LUA_AddHandle(void *data, int ref);
+
+static void LUA_GrowHandles(void)
+{
+	luahandle_t *old = luahandles;
+	size_t oldsize = luahandlesize, i;
+
+	luahandlesize = oldsize ? oldsize*2 : 1024;
+	luahandles = Z_Calloc(luahandlesize * sizeof (*luahandles), PU_STATIC, NULL);
+	numluahandles = 0;
+
+	for (i = 0; i < oldsize; i++)
+		if (LUAHANDLE_USED(&old[i]))
+			LUA_AddHandle(old[i].data, old[i].ref);
+
+	if (old)
+		Z_Free(old);
+}
+
+static void LUA_AddHandle(void *data, int ref)
+{
+	size_t i;
+
+	// keep the table at most half full
+	if ((numluahandles + 1) * 2 > luahandlesize)
+		LUA_GrowHandles();
+
+	for (i = LUA_HandleSlot(data); LUAHANDLE_USED(&luahandles[i]); i = (i + 1) & (luahandlesize - 1))
+		;
+
+	luahandles[i].data = data;
+	luahandles[i].ref = ref;
+	luahandles[i].gen = luahandlegen;
+	numluahandles++;
+}
+
+static void LUA_RemoveHandle(luahandle_t *h)
+{
+	const size_t mask = luahandlesize - 1;
+	size_t hole = h - luahandles, i = hole, want;
+
+	// Linear probing, so shift later entries of the chain back into
+	// the hole rather than leaving a tombstone.
+	for (i = (i + 1) & mask; LUAHANDLE_USED(&luahandles[i]); i = (i + 1) & mask)
+	{
+		want = LUA_HandleSlot(luahandles[i].data);
+		if ((i > hole) ? (want <= hole || want > i) : (want <= hole && want > i))
+		{
+			luahandles[hole] = luahandles[i];
+			hole = i;
+		}
+	}
+
+	luahandles[hole].data = NULL;
+	numluahandles--;
+}
+
+static void LUA_ResetGC(void); // see LUA_Step
+static void LUA_CollectGarbage(void);
+static void LUA_ClearFields(void); // see Lua_optoption
+
+static void LUA_ClearHandles(void)
+{
+	luahandlegen++;
+	numluahandles = 0;
+}
+
 // Clear and create a new Lua state, laddo!
 // There's SCRIPTIN to be had!
 static void LUA_ClearState(void)
@@ -119,6 +401,14 @@ static void LUA_ClearState(void)
 		lua_close(gL);
 	gL = NULL;
 
+	// every userdata handle went away with the old state
+	LUA_ClearHandles();
+
+	// and so did everything in the pools
+	LUA_FreePools();
+	LUA_ResetGC();
+	LUA_ClearFields();
+
 	CONS_Printf(M_GetText("Pardon me while I initialize the Lua scripting interface...\n"));
 
 	// allocate state
@@ -129,10 +419,6 @@ static void LUA_ClearState(void)
 	luaL_openlibs(L);
 	lua_pop(L, -1);
 
-	// make LREG_VALID table for all pushed userdata cache.
-	lua_newtable(L);
-	lua_setfield(L, LUA_REGISTRYINDEX, LREG_VALID);
-
 	// open srb2 libraries
 	for(i = 0; liblist[i]; i++) {
 		lua_pushcfunction(L, liblist[i]);
@@ -161,6 +447,297 @@ void LUA_ClearExtVars(void)
 }
 #endif
 
+#ifndef NOMD5
+// Compiled chunks are cached in srb2home/luacache, one file per script,
+// named after the MD5 of the script source and its chunk name (the name
+// is baked into the debug info, so two addons sharing a script get their
+// own entries). The cache is purely local: a hit loads the exact chunk
+// that compiling the same source would have produced, so it can't make
+// this machine behave any differently in a netgame.
+//
+// File layout:
+//   magic, build id length, source key, bytecode length, MAC,
+//   build id (version, revision and build time), bytecode
+//
+// Lua 5.1 runs bytecode without verifying it, so a crafted entry would
+// mean native code execution. Entries are signed with an HMAC-MD5 keyed
+// by a secret only this install knows, and nothing unsigned is loaded.
+// Anything that doesn't match - another build or install, a truncated,
+// damaged or planted file - is ignored and overwritten with a fresh
+// compile.
+#define LUACACHE_DIR "luacache"
+#define LUACACHE_MAGIC "SRB2LUAC"
+#define LUACACHE_MAGICLEN 8
+#define LUACACHE_HEADERLEN (LUACACHE_MAGICLEN + 2 + 16 + 4 + 16)
+#define LUACACHE_SECRETLEN 32
+
+// Gets this install's signing secret, creating it on first use. Scripts
+// can't read it, since the io library only opens files in luafiles.
+// Returns false, turning the cache off, if no secret can be had.
+static boolean LUA_CacheSecret(UINT8 secret[LUACACHE_SECRETLEN])
+{
+	static UINT8 cached[LUACACHE_SECRETLEN];
+	static INT32 state = 0; // 1 if cached holds the secret, -1 if there is none
+	char path[MAX_WADPATH];
+	FILE *handle;
+
+	if (!state)
+	{
+		snprintf(path, sizeof path, "%s"PATHSEP LUACACHE_DIR PATHSEP"secret", srb2home);
+		handle = fopen(path, "rb");
+		if (handle && fread(cached, 1, LUACACHE_SECRETLEN, handle) == LUACACHE_SECRETLEN)
+			state = 1;
+		if (handle)
+			fclose(handle);
+
+		if (!state && I_GetRandomBytes(cached, LUACACHE_SECRETLEN))
+		{
+			snprintf(path, sizeof path, "%s"PATHSEP LUACACHE_DIR, srb2home);
+			I_mkdir(path, 0755);
+			snprintf(path, sizeof path, "%s"PATHSEP LUACACHE_DIR PATHSEP"secret", srb2home);
+			handle = fopen(path, "wb");
+			if (handle)
+			{
+				if (fwrite(cached, 1, LUACACHE_SECRETLEN, handle) == LUACACHE_SECRETLEN)
+					state = 1;
+				if (fclose(handle))
+					state = 0;
+			}
+		}
+
+		if (!state)
+		{
+			CONS_Alert(CONS_WARNING, M_GetText("Could not set up the Lua bytecode cache, scripts will be compiled every time.\n"));
+			state = -1;
+		}
+	}
+
+	if (state < 0)
+		return false;
+	memcpy(secret, cached, LUACACHE_SECRETLEN);
+	return true;
+}
+
+// HMAC-MD5 of the source key and data (the build id and the bytecode)
+static boolean LUA_CacheMAC(const UINT8 key[16], const UINT8 *data, size_t len, UINT8 mac[16])
+{
+	UINT8 secret[LUACACHE_SECRETLEN];
+	UINT8 outer[64 + 16];
+	UINT8 *inner;
+	INT32 i;
+
+	if (!LUA_CacheSecret(secret))
+		return false;
+
+	inner = Z_Malloc(64 + 16 + len, PU_STATIC, NULL);
+	for (i = 0; i < 64; i++)
+	{
+		const UINT8 k = (i < LUACACHE_SECRETLEN) ? secret[i] : 0;
+		inner[i] = k ^ 0x36;
+		outer[i] = k ^ 0x5c;
+	}
+	memcpy(inner + 64, key, 16);
+	memcpy(inner + 64 + 16, data, len);
+	md5_buffer((char *)inner, 64 + 16 + len, outer + 64);
+	md5_buffer((char *)outer, 64 + 16, mac);
+	Z_Free(inner);
+	return true;
+}
+
+static const char *LUA_CacheBuildId(void)
+{
+	static char buildid[128] = "";
+	if (!buildid[0])
+		snprintf(buildid, sizeof buildid, "%s %s %s %s", VERSIONSTRING, comprevision, compdate, comptime);
+	return buildid;
+}
+
+// Not va(), since the chunk name usually lives in va()'s buffer
+static void LUA_CachePath(char *path, size_t len, const UINT8 key[16])
+{
+	char hex[33];
+	INT32 i;
+	for (i = 0; i < 16; i++)
+		sprintf(&hex[i*2], "%02x", key[i]);
+	snprintf(path, len, "%s"PATHSEP LUACACHE_DIR PATHSEP"%s.luac", srb2home, hex);
+}
+
+// Try to load the cached chunk for key. Pushes the function and returns
+// true on a hit; leaves the stack alone otherwise.
+static boolean LUA_LoadCachedChunk(const UINT8 key[16], const char *chunkname)
+{
+	const char *buildid = LUA_CacheBuildId();
+	size_t idlen = strlen(buildid);
+	UINT8 header[LUACACHE_HEADERLEN];
+	UINT8 digest[16];
+	UINT8 *p, *code;
+	size_t codelen;
+	char path[MAX_WADPATH];
+	FILE *handle;
+	boolean loaded = false;
+
+	LUA_CachePath(path, sizeof path, key);
+	handle = fopen(path, "rb");
+	if (!handle)
+		return false;
+
+	p = header;
+	if (fread(header, 1, LUACACHE_HEADERLEN, handle) != LUACACHE_HEADERLEN
+	|| memcmp(p, LUACACHE_MAGIC, LUACACHE_MAGICLEN))
+	{
+		fclose(handle);
+		return false;
+	}
+	p += LUACACHE_MAGICLEN;
+
+	// the build id is variable length, so check it before reading on
+	if (READUINT16(p) != idlen)
+	{
+		fclose(handle);
+		return false;
+	}
+
+	if (memcmp(p, key, 16))
+	{
+		fclose(handle);
+		return false;
+	}
+	p += 16;
+	codelen = READUINT32(p);
+
+	code = Z_Malloc(idlen + codelen, PU_STATIC, NULL);
+	if (fread(code, 1, idlen + codelen, handle) == idlen + codelen
+	&& !memcmp(code, buildid, idlen))
+	{
+		if (LUA_CacheMAC(key, code, idlen + codelen, digest) && !memcmp(digest, p, 16))
+		{
+			if (!luaL_loadbytecode(gL, (char *)code + idlen, codelen, chunkname))
+				loaded = true;
+			else
+				lua_pop(gL, 1); // the error message
+		}
+	}
+	Z_Free(code);
+	fclose(handle);
+	return loaded;
+}
+
+typedef struct
+{
+	UINT8 *data;
+	size_t size, capacity;
+} luacachebuf_t;
+
+// must match lua_Writer
+static int cacheWriter(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	luacachebuf_t *buf = ud;
+	(void)L;
+	if (buf->size + sz > buf->capacity)
+	{
+		while (buf->size + sz > buf->capacity)
+			buf->capacity = buf->capacity ? buf->capacity*2 : 4096;
+		buf->data = Z_Realloc(buf->data, buf->capacity, PU_STATIC, NULL);
+	}
+	memcpy(buf->data + buf->size, p, sz);
+	buf->size += sz;
+	return 0;
+}
+
+// Dump the compiled function on top of the stack to the cache.
+static void LUA_SaveCachedChunk(const UINT8 key[16])
+{
+	const char *buildid = LUA_CacheBuildId();
+	size_t idlen = strlen(buildid);
+	luacachebuf_t buf = {NULL, 0, 0};
+	UINT8 header[LUACACHE_HEADERLEN];
+	UINT8 *p = header;
+	char path[MAX_WADPATH];
+	char tmppath[MAX_WADPATH+4];
+	char dirpath[MAX_WADPATH];
+	FILE *handle;
+	boolean written;
+
+	// the build id goes right before the bytecode, so both are signed at once
+	cacheWriter(gL, buildid, idlen, &buf);
+	if (lua_dump(gL, cacheWriter, &buf) || buf.size == idlen)
+	{
+		Z_Free(buf.data);
+		return;
+	}
+
+	memcpy(p, LUACACHE_MAGIC, LUACACHE_MAGICLEN);
+	p += LUACACHE_MAGICLEN;
+	WRITEUINT16(p, (UINT16)idlen);
+	memcpy(p, key, 16);
+	p += 16;
+	WRITEUINT32(p, (UINT32)(buf.size - idlen));
+	if (!LUA_CacheMAC(key, buf.data, buf.size, p))
+	{
+		Z_Free(buf.data);
+		return;
+	}
+
+	// write to a temporary file first, so that a crash or a full disk
+	// can't leave a half-written entry behind under the real name
+	LUA_CachePath(path, sizeof path, key);
+	snprintf(tmppath, sizeof tmppath, "%s.tmp", path);
+	snprintf(dirpath, sizeof dirpath, "%s"PATHSEP LUACACHE_DIR, srb2home);
+	I_mkdir(dirpath, 0755);
+	handle = fopen(tmppath, "wb");
+	if (!handle)
+	{
+		Z_Free(buf.data);
+		return;
+	}
+	written = (fwrite(header, 1, LUACACHE_HEADERLEN, handle) == LUACACHE_HEADERLEN
+		&& fwrite(buf.data, 1, buf.size, handle) == buf.size);
+	if (fclose(handle))
+		written = false;
+	Z_Free(buf.data);
+
+	remove(path);
+	if (!written || rename(tmppath, path))
+		remove(tmppath);
+}
+#endif
+
+// Compile a script, or fetch it from the bytecode cache if it was
+// compiled before. Returns nonzero with the error message on the stack
+// on failure, just like luaL_loadbuffer.
+static int LUA_LoadChunk(MYFILE *f, const char *chunkname)
+{
+#ifndef NOMD5
+	UINT8 key[16];
+	UINT8 *keysrc;
+	size_t namelen = strlen(chunkname);
+	int status;
+
+	// Addons given on the command line load before the cvar is registered,
+	// so it only counts once it is; -noluacache covers that stage too.
+	if ((cv_lua_bytecodecache.string && !cv_lua_bytecodecache.value)
+	|| M_CheckParm("-noluacache"))
+		return luaL_loadbuffer(gL, f->data, f->size, chunkname);
+
+	// key = MD5(MD5(source) .. chunkname)
+	keysrc = Z_Malloc(16 + namelen, PU_STATIC, NULL);
+	md5_buffer(f->data, f->size, keysrc);
+	memcpy(keysrc + 16, chunkname, namelen);
+	md5_buffer((char *)keysrc, 16 + namelen, key);
+	Z_Free(keysrc);
+
+	if (LUA_LoadCachedChunk(key, chunkname))
+		return 0;
+
+	status = luaL_loadbuffer(gL, f->data, f->size, chunkname);
+	if (!status)
+		LUA_SaveCachedChunk(key);
+	return status;
+#else
+	return luaL_loadbuffer(gL, f->data, f->size, chunkname);
+#endif
+}
+
 // Load a script from a MYFILE
 static inline void LUA_LoadFile(MYFILE *f, char *name)
 {
@@ -172,11 +749,11 @@ static inline void LUA_LoadFile(MYFILE *f, char *name)
 	lua_pushinteger(gL, f->wad);
 	lua_setfield(gL, LUA_REGISTRYINDEX, "WAD");
 
-	if (luaL_loadbuffer(gL, f->data, f->size, va("@%s",name)) || lua_pcall(gL, 0, 0, 0)) {
+	if (LUA_LoadChunk(f, va("@%s",name)) || lua_pcall(gL, 0, 0, 0)) {
 		CONS_Alert(CONS_WARNING,"%s\n",lua_tostring(gL,-1));
 		lua_pop(gL,1);
 	}
-	lua_gc(gL, LUA_GCCOLLECT, 0);
+	LUA_CollectGarbage();
 }
 
 // Load a script from a lump
@@ -278,7 +855,7 @@ void LUA_DumpFile(const char *filename)
 		CONS_Printf("Successfully compiled %s into bytecode.\n", filename);
 	fclose(handle);
 	lua_pop(gL, 1); // function is still on stack after lua_dump
-	lua_gc(gL, LUA_GCCOLLECT, 0);
+	LUA_CollectGarbage();
 	return;
 }
 #endif
@@ -334,70 +911,64 @@ fixed_t LUA_EvalMath(const char *word)
 void LUA_PushUserdata(lua_State *L, void *data, const char *meta)
 {
 	void **userdata;
+	luahandle_t *h;
 
 	if (!data) { // push a NULL
 		lua_pushnil(L);
 		return;
 	}
 
-	lua_getfield(L, LUA_REGISTRYINDEX, LREG_VALID);
-	I_Assert(lua_istable(L, -1));
-	lua_pushlightuserdata(L, data);
-	lua_rawget(L, -2);
-	if (lua_isnil(L, -1)) { // no userdata? deary me, we'll have to make one.
-		lua_pop(L, 1); // pop the nil
+	h = LUA_FindHandle(data);
+	if (h) {
+		lua_rawgeti(L, LUA_REGISTRYINDEX, h->ref);
+		return;
+	}
 
-		// create the userdata
-		userdata = lua_newuserdata(L, sizeof(void *));
-		*userdata = data;
-		luaL_getmetatable(L, meta);
-		lua_setmetatable(L, -2);
+	// no userdata? deary me, we'll have to make one.
+	userdata = lua_newuserdata(L, sizeof(void *));
+	*userdata = data;
+	luaL_getmetatable(L, meta);
+	lua_setmetatable(L, -2);
 
-		// Set it in the registry so we can find it again
-		lua_pushlightuserdata(L, data); // k (store the userdata via the data's pointer)
-		lua_pushvalue(L, -2); // v (copy of the userdata)
-		lua_rawset(L, -4);
+	// Reference it in the registry so we can find it again
+	lua_pushvalue(L, -1);
+	LUA_AddHandle(data, luaL_ref(L, LUA_REGISTRYINDEX));
 
-		// stack is left with the userdata on top, as if getting it had originally succeeded.
-	}
-	lua_remove(L, -2); // remove LREG_VALID
+	// stack is left with the userdata on top, as if getting it had originally succeeded.
 }
 
 // When userdata is freed, use this function to remove it from Lua.
 void LUA_InvalidateUserdata(void *data)
 {
 	void **userdata;
+	luahandle_t *h;
+	int ref;
 	if (!gL)
 		return;
 
 	// fetch the userdata
-	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_VALID);
-	I_Assert(lua_istable(gL, -1));
-		lua_pushlightuserdata(gL, data);
-		lua_rawget(gL, -2);
-			if (lua_isnil(gL, -1)) { // not found, not in lua
-				lua_pop(gL, 2); // pop nil and LREG_VALID
-				return;
-			}
-
-			// nullify any additional data
-			lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
-			I_Assert(lua_istable(gL, -1));
-				lua_pushlightuserdata(gL, data);
-				lua_pushnil(gL);
-				lua_rawset(gL, -3);
-			lua_pop(gL, 1);
-
-			// invalidate the userdata
-			userdata = lua_touserdata(gL, -1);
-			*userdata = NULL;
-		lua_pop(gL, 1);
+	h = LUA_FindHandle(data);
+	if (!h) // not found, not in lua
+		return;
+	ref = h->ref;
+	LUA_RemoveHandle(h);
 
-		// remove it from the registry
+	// nullify any additional data
+	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
+	I_Assert(lua_istable(gL, -1));
 		lua_pushlightuserdata(gL, data);
 		lua_pushnil(gL);
 		lua_rawset(gL, -3);
-	lua_pop(gL, 1); // pop LREG_VALID
+	lua_pop(gL, 1);
+
+	// invalidate the userdata
+	lua_rawgeti(gL, LUA_REGISTRYINDEX, ref);
+		userdata = lua_touserdata(gL, -1);
+		*userdata = NULL;
+	lua_pop(gL, 1);
+
+	// remove it from the registry
+	luaL_unref(gL, LUA_REGISTRYINDEX, ref);
 }
 
 // Invalidate level data arrays
@@ -447,12 +1018,26 @@ void LUA_InvalidatePlayer(player_t *player)
 	LUA_InvalidateUserdata(&player->cmd);
 }
 
+// Network archive of Lua state, for players joining a netgame.
+// Strings and tables are each written out once: after its first
+// appearance a string is referred to by number (ARCH_STRINGREF), like
+// tables always are, which also keeps repeated keys of big tables out
+// of the payload. Lengths and ids are written with WriteArchiveSize.
+//
+// The tables being archived live in one Lua table (TABLESINDEX), which
+// doubles as the lookup for what was written already:
+//   tables[id] = table, tables[table] = id, tables[string] = string id
+// and, when reading, tables[-id] = string.
 enum
 {
 	ARCH_NULL=0,
-	ARCH_BOOLEAN,
+	ARCH_FALSE,
+	ARCH_TRUE,
+	ARCH_INT8,
+	ARCH_INT16,
 	ARCH_SIGNED,
 	ARCH_STRING,
+	ARCH_STRINGREF,
 	ARCH_TABLE,
 
 	ARCH_MOBJINFO,
@@ -490,6 +1075,61 @@ static const struct {
 	{NULL,          ARCH_NULL}
 };
 
+static UINT32 archivedtables; // tables numbered so far
+static UINT32 archivedstrings; // strings numbered so far
+
+// 7 bits at a time, low bits first, high bit set if more follow
+static void WriteArchiveSize(UINT32 n)
+{
+	while (n >= 0x80)
+	{
+		WRITEUINT8(save_p, (UINT8)(n | 0x80));
+		n >>= 7;
+	}
+	WRITEUINT8(save_p, (UINT8)n);
+}
+
+static UINT32 ReadArchiveSize(void)
+{
+	UINT32 n = 0;
+	INT32 shift = 0;
+	UINT8 byte;
+	do
+	{
+		byte = READUINT8(save_p);
+		n |= (UINT32)(byte & 0x7F) << shift;
+		shift += 7;
+	} while ((byte & 0x80) && shift < 32);
+	return n;
+}
+
+static void ArchiveString(int TABLESINDEX, int myindex)
+{
+	size_t len;
+	const char *str;
+
+	lua_pushvalue(gL, myindex);
+	lua_rawget(gL, TABLESINDEX);
+	if (lua_isnumber(gL, -1))
+	{
+		WRITEUINT8(save_p, ARCH_STRINGREF);
+		WriteArchiveSize((UINT32)lua_tointeger(gL, -1));
+		lua_pop(gL, 1);
+		return;
+	}
+	lua_pop(gL, 1);
+
+	// Lua strings can have embedded zeros, so this isn't WRITESTRING.
+	str = lua_tolstring(gL, myindex, &len);
+	WRITEUINT8(save_p, ARCH_STRING);
+	WriteArchiveSize((UINT32)len);
+	WRITEMEM(save_p, str, len);
+
+	lua_pushvalue(gL, myindex);
+	lua_pushinteger(gL, ++archivedstrings);
+	lua_rawset(gL, TABLESINDEX);
+}
+
 static UINT8 GetUserdataArchType(int index)
 {
 	UINT8 i;
@@ -527,62 +1167,53 @@ static UINT8 ArchiveValue(int TABLESINDEX, int myindex)
 		WRITEUINT8(save_p, ARCH_NULL);
 		return 2;
 	case LUA_TBOOLEAN:
-		WRITEUINT8(save_p, ARCH_BOOLEAN);
-		WRITEUINT8(save_p, lua_toboolean(gL, myindex));
+		WRITEUINT8(save_p, lua_toboolean(gL, myindex) ? ARCH_TRUE : ARCH_FALSE);
 		break;
 	case LUA_TNUMBER:
 	{
 		lua_Integer number = lua_tointeger(gL, myindex);
-        WRITEUINT8(save_p, ARCH_SIGNED);
-        WRITEFIXED(save_p, number);
+		if (number >= INT8_MIN && number <= INT8_MAX)
+		{
+			WRITEUINT8(save_p, ARCH_INT8);
+			WRITESINT8(save_p, number);
+		}
+		else if (number >= INT16_MIN && number <= INT16_MAX)
+		{
+			WRITEUINT8(save_p, ARCH_INT16);
+			WRITEINT16(save_p, number);
+		}
+		else
+		{
+			WRITEUINT8(save_p, ARCH_SIGNED);
+			WRITEFIXED(save_p, number);
+		}
 		break;
 	}
 	case LUA_TSTRING:
-	{
-		UINT16 len = (UINT16)lua_objlen(gL, myindex); // get length of string, including embedded zeros
-		const char *s = lua_tostring(gL, myindex);
-		UINT16 i = 0;
-		WRITEUINT8(save_p, ARCH_STRING);
-		// if you're wondering why we're writing a string to save_p this way,
-		// it turns out that Lua can have embedded zeros ('\0') in the strings,
-		// so we can't use WRITESTRING as that cuts off when it finds a '\0'.
-		// Saving the size of the string also allows us to get the size of the string on the other end,
-		// fixing the awful crashes previously encountered for reading strings longer than 1024
-		// (yes I know that's kind of a stupid thing to care about, but it'd be evil to trim or ignore them?)
-		// -- Monster Iestyn 05/08/18
-		WRITEUINT16(save_p, len); // save size of string
-		while (i < len)
-			WRITECHAR(save_p, s[i++]); // write chars individually, including the embedded zeros
+		ArchiveString(TABLESINDEX, myindex);
 		break;
-	}
 	case LUA_TTABLE:
 	{
-		boolean found = false;
-		INT32 i;
-		UINT16 t = (UINT16)lua_objlen(gL, TABLESINDEX);
+		UINT32 t;
 
-		for (i = 1; i <= t && !found; i++)
-		{
-			lua_rawgeti(gL, TABLESINDEX, i);
-			if (lua_rawequal(gL, myindex, -1))
-			{
-				t = i;
-				found = true;
-			}
-			lua_pop(gL, 1);
-		}
-		if (!found)
-			t++;
+		lua_pushvalue(gL, myindex);
+		lua_rawget(gL, TABLESINDEX);
+		t = (UINT32)lua_tointeger(gL, -1); // 0 if not seen yet
+		lua_pop(gL, 1);
 
 		WRITEUINT8(save_p, ARCH_TABLE);
-		WRITEUINT16(save_p, t);
-
-		if (!found)
+		if (!t)
 		{
+			t = ++archivedtables;
+			WriteArchiveSize(t);
 			lua_pushvalue(gL, myindex);
 			lua_rawseti(gL, TABLESINDEX, t);
+			lua_pushvalue(gL, myindex);
+			lua_pushinteger(gL, t);
+			lua_rawset(gL, TABLESINDEX);
 			return 1;
 		}
+		WriteArchiveSize(t);
 		break;
 	}
 	case LUA_TUSERDATA:
@@ -768,7 +1399,7 @@ static void ArchiveExtVars(void *pointer, const char *ptype)
 	while (lua_next(gL, -2))
 	{
 		I_Assert(lua_type(gL, -2) == LUA_TSTRING);
-		WRITESTRING(save_p, lua_tostring(gL, -2));
+		ArchiveString(TABLESINDEX, lua_gettop(gL) - 1);
 		if (ArchiveValue(TABLESINDEX, -1) == 2)
 			CONS_Alert(CONS_ERROR, "Type of value for %s entry '%s' (%s) could not be archived!\n", ptype, lua_tostring(gL, -2), luaL_typename(gL, -1));
 		lua_pop(gL, 1);
@@ -789,7 +1420,7 @@ static int NetArchive(lua_State *L)
 static void ArchiveTables(void)
 {
 	int TABLESINDEX;
-	UINT16 i, n;
+	UINT32 i;
 	UINT8 e;
 
 	if (!gL)
@@ -797,8 +1428,8 @@ static void ArchiveTables(void)
 
 	TABLESINDEX = lua_gettop(gL);
 
-	n = (UINT16)lua_objlen(gL, TABLESINDEX);
-	for (i = 1; i <= n; i++)
+	// archivedtables goes up as tables inside these are found
+	for (i = 1; i <= archivedtables; i++)
 	{
 		lua_rawgeti(gL, TABLESINDEX, i);
 		lua_pushnil(gL);
@@ -809,17 +1440,15 @@ static void ArchiveTables(void)
 			if (e == 2) // invalid key type (function, thread, lightuserdata, or anything we don't recognise)
 			{
 				lua_pushvalue(gL, -2);
-				CONS_Alert(CONS_ERROR, "Index '%s' (%s) of table %d could not be archived!\n", lua_tostring(gL, -1), luaL_typename(gL, -1), i);
+				CONS_Alert(CONS_ERROR, "Index '%s' (%s) of table %u could not be archived!\n", lua_tostring(gL, -1), luaL_typename(gL, -1), i);
 				lua_pop(gL, 1);
 			}
 			// Write value
 			e = ArchiveValue(TABLESINDEX, -1);
-			if (e == 1)
-				n++; // the table contained a new table we'll have to archive. :(
-			else if (e == 2) // invalid value type
+			if (e == 2) // invalid value type
 			{
 				lua_pushvalue(gL, -2);
-				CONS_Alert(CONS_ERROR, "Type of value for table %d entry '%s' (%s) could not be archived!\n", i, lua_tostring(gL, -1), luaL_typename(gL, -1));
+				CONS_Alert(CONS_ERROR, "Type of value for table %u entry '%s' (%s) could not be archived!\n", i, lua_tostring(gL, -1), luaL_typename(gL, -1));
 				lua_pop(gL, 1);
 			}
 
@@ -838,32 +1467,34 @@ static UINT8 UnArchiveValue(int TABLESINDEX)
 	case ARCH_NULL:
 		lua_pushnil(gL);
 		break;
-	case ARCH_BOOLEAN:
-		lua_pushboolean(gL, READUINT8(save_p));
+	case ARCH_FALSE:
+	case ARCH_TRUE:
+		lua_pushboolean(gL, type == ARCH_TRUE);
+		break;
+	case ARCH_INT8:
+		lua_pushinteger(gL, READSINT8(save_p));
+		break;
+	case ARCH_INT16:
+		lua_pushinteger(gL, READINT16(save_p));
 		break;
 	case ARCH_SIGNED:
 		lua_pushinteger(gL, READFIXED(save_p));
 		break;
 	case ARCH_STRING:
 	{
-		UINT16 len = READUINT16(save_p); // length of string, including embedded zeros
-		char *value;
-		UINT16 i = 0;
-		// See my comments in the ArchiveValue function;
-		// it's much the same for reading strings as writing them!
-		// (i.e. we can't use READSTRING either)
-		// -- Monster Iestyn 05/08/18
-		value = malloc(len); // make temp buffer of size len
-		// now read the actual string
-		while (i < len)
-			value[i++] = READCHAR(save_p); // read chars individually, including the embedded zeros
-		lua_pushlstring(gL, value, len); // push the string (note: this function supports embedded zeros)
-		free(value); // free the buffer
+		size_t len = ReadArchiveSize();
+		lua_pushlstring(gL, (const char *)save_p, len);
+		save_p += len;
+		lua_pushvalue(gL, -1);
+		lua_rawseti(gL, TABLESINDEX, -(int)(++archivedstrings));
 		break;
 	}
+	case ARCH_STRINGREF:
+		lua_rawgeti(gL, TABLESINDEX, -(int)ReadArchiveSize());
+		break;
 	case ARCH_TABLE:
 	{
-		UINT16 tid = READUINT16(save_p);
+		UINT32 tid = ReadArchiveSize();
 		lua_rawgeti(gL, TABLESINDEX, tid);
 		if (lua_isnil(gL, -1))
 		{
@@ -922,7 +1553,6 @@ static void UnArchiveExtVars(void *pointer)
 	int TABLESINDEX;
 	UINT16 field_count = READUINT16(save_p);
 	UINT16 i;
-	char field[1024];
 
 	if (field_count == 0)
 		return;
@@ -933,9 +1563,9 @@ static void UnArchiveExtVars(void *pointer)
 
 	for (i = 0; i < field_count; i++)
 	{
-		READSTRING(save_p, field);
+		UnArchiveValue(TABLESINDEX); // field name
 		UnArchiveValue(TABLESINDEX);
-		lua_setfield(gL, -2, field);
+		lua_rawset(gL, -3);
 	}
 
 	lua_getfield(gL, LUA_REGISTRYINDEX, LREG_EXTVARS);
@@ -958,14 +1588,14 @@ static int NetUnArchive(lua_State *L)
 static void UnArchiveTables(void)
 {
 	int TABLESINDEX;
-	UINT16 i, n;
+	UINT32 i, n;
 
 	if (!gL)
 		return;
 
 	TABLESINDEX = lua_gettop(gL);
 
-	n = (UINT16)lua_objlen(gL, TABLESINDEX);
+	n = (UINT32)lua_objlen(gL, TABLESINDEX);
 	for (i = 1; i <= n; i++)
 	{
 		lua_rawgeti(gL, TABLESINDEX, i);
@@ -977,7 +1607,7 @@ static void UnArchiveTables(void)
 				n++;
 			if (lua_isnil(gL, -2)) // if key is nil (if a function etc was accidentally saved)
 			{
-				CONS_Alert(CONS_ERROR, "A nil key in table %d was found! (Invalid key type or corrupted save?)\n", i);
+				CONS_Alert(CONS_ERROR, "A nil key in table %u was found! (Invalid key type or corrupted save?)\n", i);
 				lua_pop(gL, 2); // pop key and value instead of setting them in the table, to prevent Lua panic errors
 			}
 			else
@@ -987,12 +1617,125 @@ static void UnArchiveTables(void)
 	}
 }
 
+// Garbage collection is done here, once per tic, in bounded incremental
+// steps instead of whenever an allocation decides the collector should
+// run. The collector is kept stopped in between, so no collection work
+// lands in the middle of a tic. D_SRB2Loop also steps on frames where a
+// tic was due but none ran, since HUD hooks keep allocating then.
+// A full collection, including collectgarbage() from a script, restarts
+// Lua's own collector; LUA_CollectGarbage stops it again, and otherwise
+// the next step does.
+// While the collector is stopped the heap only grows by what Lua
+// allocated, which is the debt each step tries to pay back. Each
+// LUA_GCSTEP of size 0 does the work Lua would do for 1 KB of allocation.
+static INT32 luagc_livekb = 0; // heap left after the last finished cycle
+static INT32 luagc_lastkb = 0; // heap after the previous step
+static INT32 luagc_debtkb = 0; // allocation not yet paid for with collection work
+static INT32 luagc_cyclekb = 0; // allocated since the current cycle started
+static INT32 luagc_speed = 1; // budget multiplier, raised while falling behind
+static boolean luagc_incycle = false;
+static INT32 luagc_cycles = 0;
+
+static void LUA_ResetGC(void)
+{
+	luagc_livekb = luagc_lastkb = luagc_debtkb = luagc_cyclekb = 0;
+	luagc_speed = 1;
+	luagc_incycle = false;
+}
+
+// Does a full collection and hands the collector back to LUA_Step.
+// The budget cvar may not be registered yet while loading startup addons.
+static void LUA_CollectGarbage(void)
+{
+	lua_gc(gL, LUA_GCCOLLECT, 0);
+	luagc_cycles++;
+	luagc_livekb = luagc_lastkb = max(lua_gc(gL, LUA_GCCOUNT, 0), 1);
+	luagc_incycle = false;
+	luagc_debtkb = 0;
+
+	if (!cv_lua_gcbudget.string || cv_lua_gcbudget.value)
+		lua_gc(gL, LUA_GCSTOP, 0);
+}
+
 void LUA_Step(void)
 {
+	precise_t start, budget;
+	INT32 heapkb, allockb;
+
 	if (!gL)
 		return;
 	lua_settop(gL, 0);
-	lua_gc(gL, LUA_GCSTEP, 1);
+
+	start = I_GetPreciseTime();
+	heapkb = lua_gc(gL, LUA_GCCOUNT, 0);
+	allockb = max(heapkb - luagc_lastkb, 0);
+
+	if (!cv_lua_gcbudget.value)
+	{
+		// let Lua run the collector by itself
+		lua_gc(gL, LUA_GCRESTART, 0);
+		if (lua_gc(gL, LUA_GCSTEP, 1))
+			luagc_cycles++;
+		luagc_debtkb = 0;
+	}
+	else if (luagc_livekb && heapkb > luagc_livekb*8 + 8192)
+	{
+		// So far behind that stepping won't catch up, get it over with.
+		lua_gc(gL, LUA_GCCOLLECT, 0);
+		luagc_cycles++;
+		luagc_livekb = max(lua_gc(gL, LUA_GCCOUNT, 0), 1);
+		luagc_incycle = false;
+		luagc_debtkb = 0;
+		luagc_speed = min(luagc_speed*2, 16);
+		lua_gc(gL, LUA_GCSTOP, 0);
+	}
+	else
+	{
+		// Don't start a new cycle until the heap has grown as much as
+		// Lua's own pause setting would wait for.
+		if (!luagc_incycle && (!luagc_livekb || heapkb >= luagc_livekb*2))
+		{
+			luagc_incycle = true;
+			luagc_debtkb = luagc_cyclekb = 0;
+		}
+
+		if (luagc_incycle)
+		{
+			luagc_debtkb += allockb;
+			luagc_cyclekb += allockb;
+			budget = cv_lua_gcbudget.value * (I_GetPrecisePrecision() / 1000000) * luagc_speed;
+
+			do
+			{
+				if (lua_gc(gL, LUA_GCSTEP, 0)) // finished a cycle
+				{
+					// What was allocated while the cycle ran can't have
+					// been freed by it, so don't count that as live.
+					luagc_cycles++;
+					luagc_livekb = max(lua_gc(gL, LUA_GCCOUNT, 0) - luagc_cyclekb, 64);
+					luagc_incycle = false;
+					luagc_debtkb = 0;
+					break;
+				}
+				if (luagc_debtkb)
+					luagc_debtkb--;
+			} while (I_GetPreciseTime() - start < budget);
+
+			// Spend more time per tic while allocation outpaces the
+			// budget, and ease back off once it has caught up.
+			if (luagc_debtkb > allockb*4 + 64)
+				luagc_speed = min(luagc_speed*2, 16);
+			else if (!luagc_debtkb && luagc_speed > 1)
+				luagc_speed /= 2;
+		}
+
+		lua_gc(gL, LUA_GCSTOP, 0);
+	}
+
+	luagc_lastkb = lua_gc(gL, LUA_GCCOUNT, 0);
+	ps_lua_gctime.value.p = I_GetPreciseTime() - start;
+	ps_lua_heapsize.value.i = luagc_lastkb;
+	ps_lua_gccycles.value.i = luagc_cycles;
 }
 
 void LUA_Archive(void)
@@ -1002,6 +1745,7 @@ void LUA_Archive(void)
 
 	if (gL)
 		lua_newtable(gL); // tables to be archived.
+	archivedtables = archivedstrings = 0;
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
@@ -1011,7 +1755,7 @@ void LUA_Archive(void)
 		ArchiveExtVars(&players[i], "player");
 	}
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		if (th->function == (actionf_p1)P_MobjThinker)
 		{
 			// archive function will determine when to skip mobjs,
@@ -1031,10 +1775,11 @@ void LUA_UnArchive(void)
 {
 	UINT32 mobjnum;
 	INT32 i;
-	thinker_t *th;
+	thinker_t *th, *cursor;
 
 	if (gL)
 		lua_newtable(gL); // tables to be read
+	archivedtables = archivedstrings = 0;
 
 	for (i = 0; i < MAXPLAYERS; i++)
 	{
@@ -1043,13 +1788,25 @@ void LUA_UnArchive(void)
 		UnArchiveExtVars(&players[i]);
 	}
 
-	do {
-		mobjnum = READUINT32(save_p); // read a mobjnum
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
-			if (th->function == (actionf_p1)P_MobjThinker
+	// Mobjs were archived in list order, so look for each one from just
+	// after the previous match, wrapping around once at most.
+	cursor = thlist[THINK_MOBJ].cnext;
+	while ((mobjnum = READUINT32(save_p)) != UINT32_MAX) // until end of mobjs marker
+	{
+		th = cursor;
+		do
+		{
+			if (th != &thlist[THINK_MOBJ]
+			&& th->function == (actionf_p1)P_MobjThinker
 			&& ((mobj_t *)th)->mobjnum == mobjnum) // find matching mobj
+			{
 				UnArchiveExtVars(th); // apply variables
-	} while(mobjnum != UINT32_MAX); // repeat until end of mobjs marker.
+				cursor = th->cnext;
+				break;
+			}
+			th = th->cnext;
+		} while (th != cursor);
+	}
 
 	LUAh_NetArchiveHook(NetUnArchive); // call the NetArchive hook in unarchive mode
 	UnArchiveTables();
@@ -1058,12 +1815,86 @@ void LUA_UnArchive(void)
 		lua_pop(gL, 1); // pop tables
 }
 
+// Field names are looked up in a C hash table keyed by the address of
+// the name's Lua string, plus the field list it belongs to. Lua interns
+// every string and the field tables keep the names alive, so whatever
+// "x" a script indexes with is that very same string: resolving a field
+// is a pointer hash with no Lua table lookups or stack traffic at all.
+// A string that isn't in the table isn't a field of that list.
+typedef struct
+{
+	const char *name; // NULL for an empty slot
+	int list; // registry ref of the field table
+	int field;
+} luafield_t;
+
+static luafield_t *luafields = NULL;
+static size_t luafieldmask = 0; // size - 1, a power of two minus one
+static size_t numluafields = 0;
+
+#define LUAFIELD_HASH(name, list) \
+	(((((size_t)(name) >> 3) ^ (size_t)(list)) * 2654435761u) & luafieldmask)
+
+static void LUA_ClearFields(void)
+{
+	if (luafields)
+		Z_Free(luafields);
+	luafields = NULL;
+	luafieldmask = numluafields = 0;
+}
+
+static void LUA_AddField(const char *name, int list, int field);
+
+static void LUA_GrowFields(void)
+{
+	luafield_t *old = luafields;
+	size_t i, oldsize = old ? luafieldmask + 1 : 0;
+
+	luafieldmask = oldsize ? oldsize*2 - 1 : 255;
+	luafields = Z_Calloc((luafieldmask + 1) * sizeof (*luafields), PU_STATIC, NULL);
+	numluafields = 0;
+	for (i = 0; i < oldsize; i++)
+		if (old[i].name)
+			LUA_AddField(old[i].name, old[i].list, old[i].field);
+	if (old)
+		Z_Free(old);
+}
+
+static void LUA_AddField(const char *name, int list, int field)
+{
+	size_t h;
+
+	if (!luafields || (numluafields + 1) * 2 > luafieldmask + 1) // keep it at most half full
+		LUA_GrowFields();
+
+	for (h = LUAFIELD_HASH(name, list); luafields[h].name; h = (h + 1) & luafieldmask)
+		if (luafields[h].name == name && luafields[h].list == list)
+			break; // duplicate name, the later one wins as in the Lua table
+	if (!luafields[h].name)
+		numluafields++;
+	luafields[h].name = name;
+	luafields[h].list = list;
+	luafields[h].field = field;
+}
+
 // For mobj_t, player_t, etc. to take custom variables.
 int Lua_optoption(lua_State *L, int narg, int def, int list_ref)
 {
 	if (lua_isnoneornil(L, narg))
 		return def;
 
+	if (lua_type(L, narg) == LUA_TSTRING && luafields)
+	{
+		const char *name = lua_tostring(L, narg);
+		size_t h;
+		for (h = LUAFIELD_HASH(name, list_ref); luafields[h].name; h = (h + 1) & luafieldmask)
+			if (luafields[h].name == name && luafields[h].list == list_ref)
+				return luafields[h].field;
+		return -1;
+	}
+
+	// numbers and such are turned into strings by luaL_checkstring
+
 	I_Assert(lua_checkstack(L, 2));
 	luaL_checkstring(L, narg);
 
@@ -1077,17 +1908,108 @@ int Lua_optoption(lua_State *L, int narg, int def, int list_ref)
 	return -1;
 }
 
+// luaL_checkudata for the hottest userdata types. luaL_checkudata looks
+// the metatable up in the registry by name, which means interning tname
+// on every call; this compares against the metatable's address instead,
+// which its library keeps from when it was created.
+void *LUA_CheckUdata(lua_State *L, int narg, const void *meta, const char *tname)
+{
+	void *p = lua_touserdata(L, narg);
+	if (p && lua_getmetatable(L, narg))
+	{
+		boolean match = (lua_topointer(L, -1) == meta);
+		lua_pop(L, 1);
+		if (match)
+			return p;
+	}
+	return luaL_checkudata(L, narg, tname); // to raise the usual error
+}
+
+#ifdef DEVELOP
+// Common ways scripts touch mobj and player fields, each run as a loop
+// of n iterations given (mo, player, n). The empty loop and the plain
+// table get are there to compare the rest against.
+static const struct
+{
+	const char *name;
+	const char *code;
+} luafieldbench[] = {
+	{"empty loop", "local mo, p, n = ... for i = 1, n do end"},
+	{"table get", "local mo, p, n = ... local t, v = {x = 0} for i = 1, n do v = t.x end"},
+	{"mo.x", "local mo, p, n = ... local v for i = 1, n do v = mo.x end"},
+	{"mo.valid", "local mo, p, n = ... local v for i = 1, n do v = mo.valid end"},
+	{"mo.flags & MF_", "local mo, p, n = ... local v for i = 1, n do v = mo.flags & MF_SOLID end"},
+	{"p.mo.x", "local mo, p, n = ... local v for i = 1, n do v = p.mo.x end"},
+	{"mo.momz = mo.momz", "local mo, p, n = ... for i = 1, n do mo.momz = mo.momz end"},
+	{"mo.customvar", "local mo, p, n = ... local v for i = 1, n do v = mo.luafieldbench end"},
+	{NULL, NULL}
+};
+
+// Times field access from Lua on the console player's mobj.
+void Command_LuaFieldBench_f(void)
+{
+	INT32 i, n = 1000000;
+	precise_t start, time;
+
+	if (!gL)
+	{
+		CONS_Printf(M_GetText("Lua is not running.\n"));
+		return;
+	}
+	if (!playeringame[consoleplayer] || !players[consoleplayer].mo)
+	{
+		CONS_Printf(M_GetText("You must be in a level to use this.\n"));
+		return;
+	}
+	if (COM_Argc() > 1)
+		n = max(atoi(COM_Argv(1)), 1);
+
+	lua_settop(gL, 0);
+	CONS_Printf("%d iterations:\n", n);
+	for (i = 0; luafieldbench[i].name; i++)
+	{
+		if (luaL_loadstring(gL, luafieldbench[i].code))
+		{
+			CONS_Alert(CONS_WARNING, "%s\n", lua_tostring(gL, -1));
+			lua_pop(gL, 1);
+			continue;
+		}
+		LUA_PushUserdata(gL, players[consoleplayer].mo, META_MOBJ);
+		LUA_PushUserdata(gL, &players[consoleplayer], META_PLAYER);
+		lua_pushinteger(gL, n);
+
+		start = I_GetPreciseTime();
+		if (lua_pcall(gL, 3, 0, 0))
+		{
+			CONS_Alert(CONS_WARNING, "%s\n", lua_tostring(gL, -1));
+			lua_pop(gL, 1);
+			continue;
+		}
+		time = I_GetPreciseTime() - start;
+
+		CONS_Printf(" %-20s %5d ns\n", luafieldbench[i].name,
+			(int)(time * 1000000000 / I_GetPrecisePrecision() / n));
+	}
+}
+#endif
+
 int Lua_CreateFieldTable(lua_State *L, const char *const lst[])
 {
-	int i;
+	int i, ref;
 
 	lua_newtable(L);
+	ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
 	for (i = 0; lst[i] != NULL; i++)
 	{
 		lua_pushstring(L, lst[i]);
+		// the table keeps this string, and with it the address, alive
+		LUA_AddField(lua_tostring(L, -1), ref, i);
 		lua_pushinteger(L, i);
 		lua_settable(L, -3);
 	}
+	lua_pop(L, 1);
 
-	return luaL_ref(L, LUA_REGISTRYINDEX);
+	return ref;
 }
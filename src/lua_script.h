@@ -47,12 +47,18 @@ void LUA_InvalidateLevel(void);
 void LUA_InvalidateMapthings(void);
 void LUA_InvalidatePlayer(player_t *player);
 void LUA_Step(void);
+void Command_LuaMem_f(void);
 void LUA_Archive(void);
 void LUA_UnArchive(void);
 void Got_Luacmd(UINT8 **cp, INT32 playernum); // lua_consolelib.c
 void LUA_CVarChanged(const char *name); // lua_consolelib.c
+boolean LUA_HasAction(const char *action); // lua_infolib.c
 int Lua_optoption(lua_State *L, int narg, int def, int list_ref);
 int Lua_CreateFieldTable(lua_State *L, const char *const lst[]);
+void *LUA_CheckUdata(lua_State *L, int narg, const void *meta, const char *tname);
+#ifdef DEVELOP
+void Command_LuaFieldBench_f(void); // Times Lua field access
+#endif
 void LUAh_NetArchiveHook(lua_CFunction archFunc);
 
 // Console wrapper
@@ -16,6 +16,7 @@
 #include "lua_libs.h"
 
 #define META_ITERATIONSTATE "iteration state"
+#define META_MOBJSNAPSHOT "mobj snapshot"
 
 static const char *const iter_opt[] = {
 	"all",
@@ -27,11 +28,21 @@ static const actionf_p1 iter_funcs[] = {
 	(actionf_p1)P_MobjThinker
 };
 
+// Class list to walk for each option; "all" has to use the main list.
+static const INT32 iter_lists[] = {
+	-1,
+	THINK_MOBJ
+};
+
 struct iterationState {
 	actionf_p1 filter;
+	thinker_t *cap;
 	int next;
 };
 
+// Step along whichever list the iteration is walking.
+#define iter_next(it, th) ((it)->cap == &thinkercap ? (th)->next : (th)->cnext)
+
 static int iterationState_gc(lua_State *L)
 {
 	struct iterationState *it = luaL_checkudata(L, -1, META_ITERATIONSTATE);
@@ -57,7 +68,7 @@ static int lib_iterateThinkers(lua_State *L)
 	lua_settop(L, 2);
 
 	if (lua_isnil(L, 2))
-		th = &thinkercap;
+		th = it->cap;
 	else if (lua_isuserdata(L, 2))
 	{
 		if (lua_islightuserdata(L, 2))
@@ -83,17 +94,17 @@ static int lib_iterateThinkers(lua_State *L)
 	it->next = LUA_REFNIL;
 
 	if (th && !next)
-		next = th->next;
+		next = iter_next(it, th);
 	if (!next)
 		return luaL_error(L, "next thinker invalidated during iteration");
 
-	for (; next != &thinkercap; next = next->next)
+	for (; next != it->cap; next = iter_next(it, next))
 		if (!it->filter || next->function == it->filter)
 		{
 			push_thinker(next);
-			if (next->next != &thinkercap)
+			if (iter_next(it, next) != it->cap)
 			{
-				push_thinker(next->next);
+				push_thinker(iter_next(it, next));
 				it->next = luaL_ref(L, LUA_REGISTRYINDEX);
 			}
 			return 1;
@@ -101,21 +112,211 @@ static int lib_iterateThinkers(lua_State *L)
 	return 0;
 }
 
-static int lib_startIterate(lua_State *L)
+// Pushes the function and state for walking a thinker list.
+static void PushIterationState(lua_State *L, int opt)
 {
 	struct iterationState *it;
 
-	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_pushvalue(L, lua_upvalueindex(1)); // lib_iterateThinkers
 	it = lua_newuserdata(L, sizeof(struct iterationState));
 	luaL_getmetatable(L, META_ITERATIONSTATE);
 	lua_setmetatable(L, -2);
 
-	it->filter = iter_funcs[luaL_checkoption(L, 1, "mobj", iter_opt)];
+	it->filter = iter_funcs[opt];
+	it->cap = (iter_lists[opt] == -1) ? &thinkercap : &thlist[iter_lists[opt]];
 	it->next = LUA_REFNIL;
+}
+
+static int lib_startIterate(lua_State *L)
+{
+	PushIterationState(L, luaL_checkoption(L, 1, "mobj", iter_opt));
+	return 2;
+}
+
+// The filtered mobj iterators pick out their matches on the C side up
+// front, so Lua only ever sees the mobjs it asked for. The matches are
+// kept as userdata in the snapshot's environment table, which makes it
+// safe to remove them (or change their type) mid-loop: removed ones are
+// invalidated and skipped. Mobjs spawned during the loop aren't visited.
+struct mobjSnapshot {
+	int pos, count;
+};
+
+static int lib_iterateSnapshot(lua_State *L)
+{
+	struct mobjSnapshot *it = luaL_checkudata(L, 1, META_MOBJSNAPSHOT);
+	lua_getfenv(L, 1);
+	while (it->pos < it->count)
+	{
+		lua_rawgeti(L, -1, ++it->pos);
+		if (*(mobj_t **)lua_touserdata(L, -1))
+			return 1;
+		lua_pop(L, 1);
+	}
+	return 0;
+}
+
+// Pushes the function and an empty snapshot, with its table on top.
+static struct mobjSnapshot *PushSnapshot(lua_State *L)
+{
+	struct mobjSnapshot *it;
+
+	lua_pushvalue(L, lua_upvalueindex(2)); // lib_iterateSnapshot
+	it = lua_newuserdata(L, sizeof(struct mobjSnapshot));
+	luaL_getmetatable(L, META_MOBJSNAPSHOT);
+	lua_setmetatable(L, -2);
+	it->pos = it->count = 0;
+
+	lua_newtable(L);
+	lua_pushvalue(L, -1);
+	lua_setfenv(L, -3);
+	return it;
+}
+
+static inline void SnapshotAdd(lua_State *L, struct mobjSnapshot *it, mobj_t *mo)
+{
+	LUA_PushUserdata(L, mo, META_MOBJ);
+	lua_rawseti(L, -2, ++it->count);
+}
+
+// Optional type argument: nil for any type, otherwise an MT_ number.
+static mobjtype_t CheckTypeFilter(lua_State *L, int idx)
+{
+	lua_Integer type;
+	if (lua_isnoneornil(L, idx))
+		return NUMMOBJTYPES;
+	type = luaL_checkinteger(L, idx);
+	if (type < 0 || type >= NUMMOBJTYPES)
+		luaL_error(L, "mobj type %d out of range (0 - %d)", (int)type, NUMMOBJTYPES-1);
+	return (mobjtype_t)type;
+}
+
+// mobjs.iterate([type], [flags])
+// With no arguments, the same as thinkers.iterate("mobj"). Otherwise only
+// mobjs of the given type (walking just the list for that type), with
+// all of the given MF_ flags set.
+static int lib_iterateMobjs(lua_State *L)
+{
+	struct mobjSnapshot *it;
+	mobjtype_t type = CheckTypeFilter(L, 1);
+	UINT32 flags = (UINT32)luaL_optinteger(L, 2, 0);
+	mobj_t *mo;
+	thinker_t *th;
+
+	if (type == NUMMOBJTYPES && !flags)
+	{
+		PushIterationState(L, 1); // "mobj"
+		return 2;
+	}
+
+	it = PushSnapshot(L);
+	if (type != NUMMOBJTYPES)
+	{
+		for (mo = mobjtypelist[type]; mo; mo = mo->tnext)
+			if (!P_MobjWasRemoved(mo) && (mo->flags & flags) == flags)
+				SnapshotAdd(L, it, mo);
+	}
+	else
+	{
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
+		{
+			mo = (mobj_t *)th;
+			if (!P_MobjWasRemoved(mo) && (mo->flags & flags) == flags)
+				SnapshotAdd(L, it, mo);
+		}
+	}
+	lua_pop(L, 1); // snapshot table
+	return 2;
+}
+
+// mobjs.iterateRadius(x, y, radius, [type], [flags])
+// mobjs.iterateRadius(mobj, radius, [type], [flags])
+// Mobjs whose centre is within radius of the point (or of mobj, which is
+// left out itself), found through the thing blockmap, so ones with
+// MF_NOBLOCKMAP never are. The same type and flags filters as iterate.
+static int lib_iterateMobjsRadius(lua_State *L)
+{
+	struct mobjSnapshot *it;
+	mobj_t *origin = NULL, *mo;
+	fixed_t x, y, radius;
+	mobjtype_t type;
+	UINT32 flags;
+	INT64 lo, hi;
+	UINT64 maxdist;
+	INT32 xl, xh, yl, yh, bx, by;
+	int arg;
+
+	if (lua_isuserdata(L, 1))
+	{
+		origin = *((mobj_t **)luaL_checkudata(L, 1, META_MOBJ));
+		if (!origin)
+			return LUA_ErrInvalid(L, "mobj_t");
+		x = origin->x;
+		y = origin->y;
+		arg = 2;
+	}
+	else
+	{
+		x = luaL_checkfixed(L, 1);
+		y = luaL_checkfixed(L, 2);
+		arg = 3;
+	}
+	radius = luaL_checkfixed(L, arg);
+	if (radius < 0)
+		return luaL_error(L, "radius must not be negative");
+	type = CheckTypeFilter(L, arg+1);
+	flags = (UINT32)luaL_optinteger(L, arg+2, 0);
+
+	it = PushSnapshot(L);
+	if (!blocklinks)
+	{
+		lua_pop(L, 1);
+		return 2;
+	}
+
+	// in 64 bits, so a huge radius can't wrap around
+	lo = (INT64)x - radius - bmaporgx;
+	hi = (INT64)x + radius - bmaporgx;
+	xl = (lo < 0) ? 0 : (INT32)min(lo>>THINGBLOCKSHIFT, thingmapwidth);
+	xh = (hi < 0) ? -1 : (INT32)min(hi>>THINGBLOCKSHIFT, thingmapwidth-1);
+	lo = (INT64)y - radius - bmaporgy;
+	hi = (INT64)y + radius - bmaporgy;
+	yl = (lo < 0) ? 0 : (INT32)min(lo>>THINGBLOCKSHIFT, thingmapheight);
+	yh = (hi < 0) ? -1 : (INT32)min(hi>>THINGBLOCKSHIFT, thingmapheight-1);
+
+	maxdist = (UINT64)radius * (UINT64)radius;
+
+	for (bx = xl; bx <= xh; bx++)
+		for (by = yl; by <= yh; by++)
+			for (mo = blocklinks[by*thingmapwidth + bx]; mo; mo = mo->bnext)
+			{
+				INT64 dx, dy;
+
+				if (mo == origin || P_MobjWasRemoved(mo))
+					continue;
+				if (type != NUMMOBJTYPES && mo->type != type)
+					continue;
+				if ((mo->flags & flags) != flags)
+					continue;
+
+				dx = (INT64)mo->x - x;
+				dy = (INT64)mo->y - y;
+				if (dx < 0)
+					dx = -dx;
+				if (dy < 0)
+					dy = -dy;
+				if (dx > radius || dy > radius
+				|| (UINT64)(dx*dx) + (UINT64)(dy*dy) > maxdist)
+					continue;
+
+				SnapshotAdd(L, it, mo);
+			}
+	lua_pop(L, 1); // snapshot table
 	return 2;
 }
 
 #undef push_thinker
+#undef iter_next
 
 int LUA_ThinkerLib(lua_State *L)
 {
@@ -124,10 +325,24 @@ int LUA_ThinkerLib(lua_State *L)
 	lua_setfield(L, -2, "__gc");
 	lua_pop(L, 1);
 
+	luaL_newmetatable(L, META_MOBJSNAPSHOT);
+	lua_pop(L, 1);
+
 	lua_createtable(L, 0, 1);
 		lua_pushcfunction(L, lib_iterateThinkers);
 		lua_pushcclosure(L, lib_startIterate, 1);
 		lua_setfield(L, -2, "iterate");
 	lua_setglobal(L, "thinkers");
+
+	lua_createtable(L, 0, 2);
+		lua_pushcfunction(L, lib_iterateThinkers);
+		lua_pushcfunction(L, lib_iterateSnapshot);
+		lua_pushcclosure(L, lib_iterateMobjs, 2);
+		lua_setfield(L, -2, "iterate");
+		lua_pushcfunction(L, lib_iterateThinkers);
+		lua_pushcfunction(L, lib_iterateSnapshot);
+		lua_pushcclosure(L, lib_iterateMobjsRadius, 2);
+		lua_setfield(L, -2, "iterateRadius");
+	lua_setglobal(L, "mobjs");
 	return 0;
 }
@@ -18,6 +18,11 @@
 #include "z_zone.h"
 #include "p_local.h"
 #include "r_fps.h"
+#include "p_spec.h"
+#include "p_polyobj.h"
+#include "dehacked.h" // DEH_MobjTypeName
+#include "d_main.h" // srb2home
+#include "m_misc.h" // FIL_ForceExtension
 
 #ifdef HWRENDER
 #include "hardware/hw_main.h"
@@ -62,12 +67,94 @@ static ps_metric_t ps_precipcount = {0};
 static ps_metric_t ps_removecount = {0};
 
 ps_metric_t ps_checkposition_calls = {0};
+ps_metric_t ps_dormant_mobjs = {0};
+ps_metric_t ps_thingpair_tests = {0};
+ps_metric_t ps_sight_checks = {0};
+ps_metric_t ps_sight_cachehits = {0};
 
 ps_metric_t ps_lua_thinkframe_time = {0};
 ps_metric_t ps_lua_mobjhooks = {0};
 
+ps_metric_t ps_lua_gctime = {0};
+ps_metric_t ps_lua_heapsize = {0};
+ps_metric_t ps_lua_gccycles = {0};
+
 ps_metric_t ps_otherlogictime = {0};
 
+// Per-thinker-type timing, shown by perfstats 4.
+// Mobjs are accounted by type, other thinkers by their function.
+
+typedef struct
+{
+	actionf_p1 function;
+	const char *name;
+} ps_thinkerfunc_t;
+
+#define PS_THINKERFUNC(f) {(actionf_p1)f, #f}
+
+static const ps_thinkerfunc_t ps_thinkerfuncs[] = {
+	PS_THINKERFUNC(P_RemoveThinkerDelayed),
+	PS_THINKERFUNC(P_RainThinker),
+	PS_THINKERFUNC(P_SnowThinker),
+	PS_THINKERFUNC(P_NullPrecipThinker),
+	PS_THINKERFUNC(T_BounceCheese),
+	PS_THINKERFUNC(T_BridgeThinker),
+	PS_THINKERFUNC(T_CameraScanner),
+	PS_THINKERFUNC(T_ContinuousFalling),
+	PS_THINKERFUNC(T_CrushCeiling),
+	PS_THINKERFUNC(T_Disappear),
+	PS_THINKERFUNC(T_EachTimeThinker),
+	PS_THINKERFUNC(T_ExecutorDelay),
+	PS_THINKERFUNC(T_FireFlicker),
+	PS_THINKERFUNC(T_FloatSector),
+	PS_THINKERFUNC(T_Friction),
+	PS_THINKERFUNC(T_Glow),
+	PS_THINKERFUNC(T_LaserFlash),
+	PS_THINKERFUNC(T_LightFade),
+	PS_THINKERFUNC(T_LightningFlash),
+	PS_THINKERFUNC(T_MarioBlock),
+	PS_THINKERFUNC(T_MarioBlockChecker),
+	PS_THINKERFUNC(T_MoveCeiling),
+	PS_THINKERFUNC(T_MoveElevator),
+	PS_THINKERFUNC(T_MoveFloor),
+	PS_THINKERFUNC(T_NoEnemiesSector),
+	PS_THINKERFUNC(T_PolyDoorSlide),
+	PS_THINKERFUNC(T_PolyDoorSwing),
+	PS_THINKERFUNC(T_PolyObjDisplace),
+	PS_THINKERFUNC(T_PolyObjFlag),
+	PS_THINKERFUNC(T_PolyObjMove),
+	PS_THINKERFUNC(T_PolyObjRotate),
+	PS_THINKERFUNC(T_PolyObjWaypoint),
+	PS_THINKERFUNC(T_Pusher),
+	PS_THINKERFUNC(T_RaiseSector),
+	PS_THINKERFUNC(T_Scroll),
+	PS_THINKERFUNC(T_SpikeSector),
+	PS_THINKERFUNC(T_StartCrumble),
+	PS_THINKERFUNC(T_StrobeFlash),
+	PS_THINKERFUNC(T_ThwompSector),
+};
+
+#undef PS_THINKERFUNC
+
+#define NUMPSTHINKERFUNCS (sizeof ps_thinkerfuncs / sizeof *ps_thinkerfuncs)
+#define NUMPSTHINKERSLOTS (NUMMOBJTYPES + NUMPSTHINKERFUNCS + 1) // last slot is "Other"
+
+typedef struct
+{
+	precise_t time;
+	UINT32 calls;
+} ps_thinkerslot_t;
+
+// Slots being filled in during the current sample window,
+// and the last completed window which is what gets shown.
+static ps_thinkerslot_t ps_thinker_window[NUMPSTHINKERSLOTS];
+static ps_thinkerslot_t ps_thinker_shown[NUMPSTHINKERSLOTS];
+static INT32 ps_thinker_windowtics = 0;
+static INT32 ps_thinker_showntics = 0;
+
+// Shown slots in display order, rebuilt by PS_SortThinkerSlots.
+static UINT16 ps_thinker_order[NUMPSTHINKERSLOTS];
+
 // Columns for perfstats pages.
 
 // Position on screen is determined separately in the drawing functions.
@@ -119,6 +206,10 @@ perfstatrow_t commoncounter_rows[] = {
 	{"sprites", "Sprites:     ", &ps_numsprites, 0},
 	{"drwnode", "Drawnodes:   ", &ps_numdrawnodes, 0},
 	{"plyobjs", "Polyobjects: ", &ps_numpolyobjects, 0},
+#ifdef HWRENDER
+	{"frstcul", "Frustum cull:", &ps_hw_numfrustumculled, PS_HW},
+	{"clipcul", "Clipper cull:", &ps_hw_numclipculled, PS_HW},
+#endif
 	{0}
 };
 
@@ -132,6 +223,8 @@ perfstatrow_t interpolation_rows[] = {
 perfstatrow_t batchcount_rows[] = {
 	{"polygon", "Polygons:  ", &ps_hw_numpolys, 0},
 	{"vertex ", "Vertices:  ", &ps_hw_numverts, 0},
+	{"2dpolys", "2D polys:  ", &ps_hw_num2dpolys, 0},
+	{"2dcalls", "2D calls:  ", &ps_hw_num2dcalls, 0},
 	{0}
 };
 
@@ -161,6 +254,13 @@ perfstatrow_t gamelogic_rows[] = {
 	{0}
 };
 
+perfstatrow_t luagc_rows[] = {
+	{"luagc  ", "Lua GC:         ", &ps_lua_gctime, PS_TIME},
+	{" heapkb ", " Heap (KB):      ", &ps_lua_heapsize, 0},
+	{" cycles ", " Cycles:         ", &ps_lua_gccycles, 0},
+	{0}
+};
+
 perfstatrow_t thinkercount_rows[] = {
 	{"thnkers", "Thinkers:       ", &ps_thinkercount, PS_LEVEL},
 	{" mobjs  ", " Mobjs:          ", &ps_mobjcount, PS_LEVEL},
@@ -176,6 +276,10 @@ perfstatrow_t thinkercount_rows[] = {
 perfstatrow_t misc_calls_rows[] = {
 	{"lmhook", "Lua mobj hooks: ", &ps_lua_mobjhooks, PS_LEVEL},
 	{"chkpos", "P_CheckPosition:", &ps_checkposition_calls, PS_LEVEL},
+	{"dormnt", "Dormant mobjs:  ", &ps_dormant_mobjs, PS_LEVEL},
+	{"thpair", "Thing pairs:    ", &ps_thingpair_tests, PS_LEVEL},
+	{"sight ", "Sight checks:   ", &ps_sight_checks, PS_LEVEL},
+	{" cache", " Cached:        ", &ps_sight_cachehits, PS_LEVEL},
 	{0}
 };
 
@@ -218,6 +322,203 @@ void PS_SetThinkFrameHookInfo(int index, precise_t time_taken, char* short_src)
 	thinkframe_hooks_length = index + 1;
 }
 
+// Lua profiler: time spent in each hook and HUD function, kept apart
+// by what called it and where the function was defined.
+// Times are exclusive, time spent in hooks run from inside another
+// hook only counts for the inner one.
+
+typedef struct
+{
+	const char *what; // hook or HUD type
+	const void *func; // lua_topointer of the function
+	char name[LUA_IDSIZE+16]; // short_src:linedefined
+	precise_t time;
+	UINT32 calls;
+	INT32 next; // next entry in the same bucket
+} ps_luaprofentry_t;
+
+#define LUAPROFBUCKETS 256
+
+boolean ps_luaprof_active = false;
+static ps_luaprofentry_t *ps_luaprof_entries = NULL;
+static INT32 ps_luaprof_numentries = 0;
+static INT32 ps_luaprof_maxentries = 0;
+static INT32 ps_luaprof_buckets[LUAPROFBUCKETS];
+static INT32 ps_luaprof_tics = 0;
+static INT32 ps_luaprof_ticsleft = 0;
+static precise_t ps_luaprof_nested = 0;
+static char ps_luaprof_filename[256];
+
+void PS_LuaProfEnter(ps_luaprofcall_t *call)
+{
+	call->outer = ps_luaprof_nested;
+	ps_luaprof_nested = 0;
+	call->start = I_GetPreciseTime();
+}
+
+// Expects the function that was called on top of the stack, and pops it.
+void PS_LuaProfLeave(ps_luaprofcall_t *call, lua_State *L, const char *what)
+{
+	const precise_t total = I_GetPreciseTime() - call->start;
+	const void *func = lua_topointer(L, -1);
+	const size_t bucket = (((size_t)func >> 4) ^ ((size_t)what >> 2)) % LUAPROFBUCKETS;
+	ps_luaprofentry_t *entry = NULL;
+	INT32 i;
+
+	for (i = ps_luaprof_buckets[bucket]; i != -1; i = ps_luaprof_entries[i].next)
+		if (ps_luaprof_entries[i].func == func && ps_luaprof_entries[i].what == what)
+		{
+			entry = &ps_luaprof_entries[i];
+			break;
+		}
+
+	if (entry)
+		lua_pop(L, 1);
+	else
+	{
+		lua_Debug ar;
+
+		if (ps_luaprof_numentries >= ps_luaprof_maxentries)
+		{
+			ps_luaprof_maxentries = ps_luaprof_maxentries ? ps_luaprof_maxentries*2 : 64;
+			ps_luaprof_entries = Z_Realloc(ps_luaprof_entries,
+				ps_luaprof_maxentries * sizeof (*ps_luaprof_entries), PU_STATIC, NULL);
+		}
+		entry = &ps_luaprof_entries[ps_luaprof_numentries];
+		entry->what = what;
+		entry->func = func;
+		entry->time = 0;
+		entry->calls = 0;
+		entry->next = ps_luaprof_buckets[bucket];
+		ps_luaprof_buckets[bucket] = ps_luaprof_numentries++;
+
+		lua_getinfo(L, ">S", &ar); // pops the function
+		snprintf(entry->name, sizeof entry->name, "%s:%d", ar.short_src, ar.linedefined);
+	}
+
+	entry->time += total - ps_luaprof_nested;
+	entry->calls++;
+	ps_luaprof_nested = call->outer + total;
+}
+
+static void PS_LuaProfReset(void)
+{
+	INT32 i;
+	for (i = 0; i < LUAPROFBUCKETS; i++)
+		ps_luaprof_buckets[i] = -1;
+	ps_luaprof_numentries = 0;
+	ps_luaprof_nested = 0;
+}
+
+static int PS_CompareLuaProfEntries(const void *p1, const void *p2)
+{
+	const ps_luaprofentry_t *e1 = p1, *e2 = p2;
+	if (e1->time != e2->time)
+		return e1->time < e2->time ? 1 : -1;
+	return 0;
+}
+
+// Copies a file name for luaprof or thinkerdump to out, forcing the given
+// extension. Scripts can run these commands too, so only plain names are
+// allowed: the file always lands directly in srb2home.
+static boolean PS_DumpFileName(char *out, size_t size, const char *name, const char *extension)
+{
+	if (!*name || strchr(name, '/') || strchr(name, '\\') || strchr(name, ':')
+		|| strstr(name, PATHSEP) || strstr(name, "..")
+		|| strlen(name) + strlen(extension) >= size)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("%s is not a valid file name, give one without a path.\n"), name);
+		return false;
+	}
+	strcpy(out, name);
+	FIL_ForceExtension(out, extension);
+	return true;
+}
+
+// Writes the profile as collapsed stacks, one "hook;file;script:line time"
+// line per function, with times in microseconds. That is the input
+// format flamegraph.pl and speedscope expect.
+static void PS_LuaProfFinish(void)
+{
+	const UINT64 us = I_GetPrecisePrecision() / 1000000;
+	char path[256+sizeof ps_luaprof_filename];
+	INT32 i;
+	FILE *f;
+
+	ps_luaprof_active = false;
+	qsort(ps_luaprof_entries, ps_luaprof_numentries, sizeof (*ps_luaprof_entries), PS_CompareLuaProfEntries);
+
+	snprintf(path, sizeof path, "%s"PATHSEP"%s", srb2home, ps_luaprof_filename);
+	f = fopen(path, "w");
+	if (!f)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Couldn't write Lua profile to %s\n"), path);
+		return;
+	}
+
+	for (i = 0; i < ps_luaprof_numentries; i++)
+	{
+		ps_luaprofentry_t *e = &ps_luaprof_entries[i];
+		char *p;
+
+		if (e->time / us == 0)
+			continue;
+
+		// split "file.pk3|script.lua" into two frames
+		for (p = e->name; *p; p++)
+			if (*p == '|' || *p == ';')
+				*p = (*p == '|') ? ';' : ',';
+
+		fprintf(f, "%s;%s %s\n", e->what, e->name, sizeu1((size_t)(e->time / us)));
+	}
+	fclose(f);
+
+	CONS_Printf(M_GetText("Lua profile of %d tics written to %s\n"), ps_luaprof_tics - ps_luaprof_ticsleft, path);
+	for (i = 0; i < min(ps_luaprof_numentries, 5); i++)
+	{
+		ps_luaprofentry_t *e = &ps_luaprof_entries[i];
+		CONS_Printf(" %s %s: %s us in %u calls\n", e->what, e->name,
+			sizeu1((size_t)(e->time / us)), e->calls);
+	}
+}
+
+// luaprof <tics> [file]: profile Lua hooks and HUD functions for a number
+// of tics and write the result to a file in srb2home.
+// luaprof stop: end early and write what was collected so far.
+void Command_LuaProf_f(void)
+{
+	if (COM_Argc() < 2)
+	{
+		if (ps_luaprof_active)
+			CONS_Printf(M_GetText("Profiling Lua, %d of %d tics left.\n"), ps_luaprof_ticsleft, ps_luaprof_tics);
+		else
+			CONS_Printf(M_GetText("luaprof <tics> [file]: profile Lua hooks for some tics\nluaprof stop: stop profiling early\n"));
+		return;
+	}
+
+	if (!stricmp(COM_Argv(1), "stop"))
+	{
+		if (ps_luaprof_active)
+			PS_LuaProfFinish();
+		return;
+	}
+
+	ps_luaprof_tics = atoi(COM_Argv(1));
+	if (ps_luaprof_tics <= 0)
+	{
+		CONS_Printf(M_GetText("The number of tics to profile must be positive.\n"));
+		return;
+	}
+	if (!PS_DumpFileName(ps_luaprof_filename, sizeof ps_luaprof_filename,
+		COM_Argc() > 2 ? COM_Argv(2) : "luaprof", ".txt"))
+		return;
+	ps_luaprof_ticsleft = ps_luaprof_tics;
+
+	PS_LuaProfReset();
+	ps_luaprof_active = true;
+	CONS_Printf(M_GetText("Profiling Lua for %d tics...\n"), ps_luaprof_tics);
+}
+
 static boolean PS_HighResolution(void)
 {
 	return (vid.width >= 640 && vid.height >= 400);
@@ -500,6 +801,7 @@ static void PS_UpdateFrameStats(void)
 static void PS_CountThinkers(void)
 {
 	thinker_t *thinker;
+	INT32 i;
 
 	ps_thinkercount.value.i = 0;
 	ps_mobjcount.value.i = 0;
@@ -509,63 +811,73 @@ static void PS_CountThinkers(void)
 	ps_otherthcount.value.i = 0;
 	ps_precipcount.value.i = 0;
 	ps_removecount.value.i = 0;
-	for (thinker = thinkercap.next; thinker != &thinkercap; thinker = thinker->next)
-	{
-		ps_thinkercount.value.i++;
-		if (thinker->function == (actionf_p1)P_RemoveThinkerDelayed)
-			ps_removecount.value.i++;
-		else if (thinker->function == (actionf_p1)P_MobjThinker)
-		{
-			mobj_t *mobj = (mobj_t*)thinker;
-			ps_mobjcount.value.i++;
-			if (mobj->flags & MF_NOTHINK)
-				ps_nothinkcount.value.i++;
-			else if (mobj->flags & MF_SCENERY)
-				ps_scenerycount.value.i++;
-			else
-				ps_regularcount.value.i++;
-		}
-		else if (thinker->function == (actionf_p1)P_NullPrecipThinker)
-			ps_precipcount.value.i++;
-		else
-			ps_otherthcount.value.i++;
-	}
-	/*for (i = 0; i < NUM_THINKERLISTS; i++)
+	for (i = 0; i < NUM_THINKERLISTS; i++)
 	{
-		for (thinker = thlist[i].next; thinker != &thlist[i]; thinker = thinker->next)
+		for (thinker = thlist[i].cnext; thinker != &thlist[i]; thinker = thinker->cnext)
 		{
 			ps_thinkercount.value.i++;
 			if (thinker->function == (actionf_p1)P_RemoveThinkerDelayed)
 				ps_removecount.value.i++;
-			else if (i == THINK_POLYOBJ)
-				ps_polythcount.value.i++;
-			else if (i == THINK_MAIN)
-				ps_mainthcount.value.i++;
 			else if (i == THINK_MOBJ)
 			{
-				if (thinker->function == (actionf_p1)P_MobjThinker)
-				{
-					mobj_t *mobj = (mobj_t*)thinker;
-					ps_mobjcount.value.i++;
-					if (mobj->flags & MF_NOTHINK)
-						ps_nothinkcount.value.i++;
-					else if (mobj->flags & MF_SCENERY)
-						ps_scenerycount.value.i++;
-					else
-						ps_regularcount.value.i++;
-				}
+				mobj_t *mobj = (mobj_t*)thinker;
+				ps_mobjcount.value.i++;
+				if (mobj->flags & MF_NOTHINK)
+					ps_nothinkcount.value.i++;
+				else if (mobj->flags & MF_SCENERY)
+					ps_scenerycount.value.i++;
+				else
+					ps_regularcount.value.i++;
 			}
-			else if (i == THINK_DYNSLOPE)
-				ps_dynslopethcount.value.i++;
 			else if (i == THINK_PRECIP)
 				ps_precipcount.value.i++;
+			else
+				ps_otherthcount.value.i++;
 		}
-	}*/
+	}
+}
+
+static size_t PS_ThinkerSlot(thinker_t *thinker)
+{
+	size_t i;
+
+	if (thinker->function == (actionf_p1)P_MobjThinker)
+		return ((mobj_t *)thinker)->type;
+
+	for (i = 0; i < NUMPSTHINKERFUNCS; i++)
+		if (thinker->function == ps_thinkerfuncs[i].function)
+			return NUMMOBJTYPES + i;
+
+	return NUMPSTHINKERSLOTS - 1;
+}
+
+// Runs a thinker and adds the time it took to its slot.
+void PS_RunTimedThinker(thinker_t *thinker)
+{
+	// The thinker may not exist anymore once it has run,
+	// so find where it belongs beforehand.
+	ps_thinkerslot_t *slot = &ps_thinker_window[PS_ThinkerSlot(thinker)];
+	precise_t start = I_GetPreciseTime();
+
+	thinker->function(thinker);
+
+	slot->time += I_GetPreciseTime() - start;
+	slot->calls++;
+}
+
+static void PS_ResetThinkerTimes(void)
+{
+	memset(ps_thinker_window, 0, sizeof ps_thinker_window);
+	memset(ps_thinker_shown, 0, sizeof ps_thinker_shown);
+	ps_thinker_windowtics = ps_thinker_showntics = 0;
 }
 
 // Update all metrics that are calculated on every tick.
 void PS_UpdateTickStats(void)
 {
+	if (ps_luaprof_active && --ps_luaprof_ticsleft <= 0)
+		PS_LuaProfFinish();
+
 	if (cv_perfstats.value == 1 && cv_ps_samplesize.value > 1)
 	{
 		PS_UpdateRowHistories(gamelogicbrief_row, false);
@@ -586,6 +898,7 @@ void PS_UpdateTickStats(void)
 		if (cv_ps_samplesize.value > 1)
 		{
 			PS_UpdateRowHistories(gamelogic_rows, false);
+			PS_UpdateRowHistories(luagc_rows, false);
 			PS_UpdateRowHistories(thinkercount_rows, false);
 			PS_UpdateRowHistories(misc_calls_rows, false);
 		}
@@ -598,6 +911,18 @@ void PS_UpdateTickStats(void)
 			PS_UpdateMetricHistory(&thinkframe_hooks[i].time_taken, true, false, false);
 		}
 	}
+	if (cv_perfstats.value == 4 && PS_IsLevelActive())
+	{
+		// Thinker times are summed over the whole sample window
+		// instead of keeping a history for each slot.
+		if (++ps_thinker_windowtics >= cv_ps_samplesize.value)
+		{
+			memcpy(ps_thinker_shown, ps_thinker_window, sizeof ps_thinker_shown);
+			ps_thinker_showntics = ps_thinker_windowtics;
+			memset(ps_thinker_window, 0, sizeof ps_thinker_window);
+			ps_thinker_windowtics = 0;
+		}
+	}
 	if (cv_perfstats.value && cv_ps_samplesize.value > 1)
 	{
 		ps_tick_index++;
@@ -694,11 +1019,13 @@ static void PS_DrawRenderStats(void)
 static void PS_DrawGameLogicStats(void)
 {
 	const boolean hires = PS_HighResolution();
+	const int half_row = hires ? 5 : 4;
 	int x, y;
 
 	PS_DrawDescriptorHeader();
 
-	PS_DrawPerfRows(20, 10, V_YELLOWMAP, gamelogic_rows);
+	y = PS_DrawPerfRows(20, 10, V_YELLOWMAP, gamelogic_rows);
+	PS_DrawPerfRows(20, y + half_row, V_GREENMAP, luagc_rows);
 
 	x = hires ? 115 : 90;
 	PS_DrawPerfRows(x, 10, V_BLUEMAP, thinkercount_rows);
@@ -794,6 +1121,139 @@ if (y > 192) \
 	}
 }
 
+static const char *PS_ThinkerSlotName(size_t slot)
+{
+	static char name[32];
+
+	if (slot < NUMMOBJTYPES)
+	{
+		const char *typename = DEH_MobjTypeName(slot);
+		if (typename)
+			snprintf(name, sizeof name, "MT_%s", typename);
+		else
+			snprintf(name, sizeof name, "MT_%s", sizeu1(slot));
+		return name;
+	}
+
+	slot -= NUMMOBJTYPES;
+	if (slot < NUMPSTHINKERFUNCS)
+		return ps_thinkerfuncs[slot].name;
+
+	return "Other";
+}
+
+static precise_t PS_ThinkerSortKey(const ps_thinkerslot_t *slot)
+{
+	if (cv_ps_thinkersort.value == 2) // calls
+		return slot->calls;
+	if (cv_ps_thinkersort.value == 3) // time per call
+		return slot->calls ? slot->time / slot->calls : 0;
+	return slot->time;
+}
+
+static int PS_CompareThinkerSlots(const void *p1, const void *p2)
+{
+	precise_t key1 = PS_ThinkerSortKey(&ps_thinker_shown[*(const UINT16 *)p1]);
+	precise_t key2 = PS_ThinkerSortKey(&ps_thinker_shown[*(const UINT16 *)p2]);
+
+	if (key1 != key2)
+		return key1 < key2 ? 1 : -1; // largest first
+	return (int)*(const UINT16 *)p1 - (int)*(const UINT16 *)p2;
+}
+
+// Fills ps_thinker_order with the slots that ran during the shown window,
+// sorted by ps_thinkersort, and returns how many there are.
+static size_t PS_SortThinkerSlots(void)
+{
+	size_t i, count = 0;
+
+	for (i = 0; i < NUMPSTHINKERSLOTS; i++)
+		if (ps_thinker_shown[i].calls)
+			ps_thinker_order[count++] = (UINT16)i;
+
+	qsort(ps_thinker_order, count, sizeof *ps_thinker_order, PS_CompareThinkerSlots);
+	return count;
+}
+
+static void PS_DrawThinkerStats(void)
+{
+	const char *sortnames[] = {"time", "calls", "time per call"};
+	const INT32 flags = V_MONOSPACE | V_ALLOWLOWERCASE;
+	const UINT64 us = I_GetPrecisePrecision() / 1000000;
+	size_t count, i;
+	int y = 12;
+
+	if (!ps_thinker_showntics)
+	{
+		V_DrawSmallString(2, 0, flags | V_REDMAP, "Collecting thinker times...");
+		return;
+	}
+
+	V_DrawSmallString(2, 0, flags | V_GREENMAP,
+		va("Thinker times over %d tics, sorted by %s.", ps_thinker_showntics,
+			sortnames[cv_ps_thinkersort.value - 1]));
+	V_DrawSmallString(2, 6, flags | V_GRAYMAP,
+		va("%-28s %10s %10s %10s", "Thinker", "us/tic", "calls/tic", "us/call"));
+
+	count = PS_SortThinkerSlots();
+	for (i = 0; i < count && y <= 196; i++, y += 4)
+	{
+		const size_t slot = ps_thinker_order[i];
+		const ps_thinkerslot_t *s = &ps_thinker_shown[slot];
+		// shown with one decimal, so keep everything in tenths
+		const INT64 timetenths = (INT64)(s->time * 10 / us);
+		const INT64 pertic = timetenths / ps_thinker_showntics;
+		const INT64 calltenths = (INT64)s->calls * 10 / ps_thinker_showntics;
+		const INT64 percall = timetenths / s->calls;
+
+		V_DrawSmallString(2, y, flags | (slot < NUMMOBJTYPES ? V_YELLOWMAP : V_BLUEMAP),
+			va("%-28.28s %8d.%d %8d.%d %8d.%d", PS_ThinkerSlotName(slot),
+				(int)(pertic / 10), (int)(pertic % 10),
+				(int)(calltenths / 10), (int)(calltenths % 10),
+				(int)(percall / 10), (int)(percall % 10)));
+	}
+}
+
+// Writes the shown thinker times to a CSV file in srb2home.
+void Command_ThinkerDump_f(void)
+{
+	const UINT64 us = I_GetPrecisePrecision() / 1000000;
+	char filename[MAX_WADPATH];
+	char path[256+MAX_WADPATH];
+	size_t count, i;
+	FILE *f;
+
+	if (!ps_thinker_showntics)
+	{
+		CONS_Printf(M_GetText("No thinker times collected yet, set perfstats to 4 during a level first.\n"));
+		return;
+	}
+
+	if (!PS_DumpFileName(filename, sizeof filename,
+		COM_Argc() > 1 ? COM_Argv(1) : "thinkertimes", ".csv"))
+		return;
+
+	snprintf(path, sizeof path, "%s"PATHSEP"%s", srb2home, filename);
+	f = fopen(path, "w");
+	if (!f)
+	{
+		CONS_Alert(CONS_WARNING, M_GetText("Couldn't write thinker times to %s\n"), path);
+		return;
+	}
+
+	fprintf(f, "name,total_us,calls,tics\n");
+	count = PS_SortThinkerSlots();
+	for (i = 0; i < count; i++)
+	{
+		const ps_thinkerslot_t *s = &ps_thinker_shown[ps_thinker_order[i]];
+		fprintf(f, "%s,%s,%u,%d\n", PS_ThinkerSlotName(ps_thinker_order[i]),
+			sizeu1((size_t)(s->time / us)), s->calls, ps_thinker_showntics);
+	}
+	fclose(f);
+
+	CONS_Printf(M_GetText("Wrote %s thinker types to %s\n"), sizeu1(count), path);
+}
+
 void M_DrawPerfStats(void)
 {
 	if (cv_perfstats.value == 1) // rendering
@@ -824,6 +1284,20 @@ void M_DrawPerfStats(void)
 			PS_DrawThinkFrameStats();
 		}
 	}
+	else if (cv_perfstats.value == 4) // thinker types
+	{
+		if (!PS_IsLevelActive())
+			return;
+		if (!PS_HighResolution())
+		{
+			V_DrawThinString(80, 92, V_MONOSPACE | V_ALLOWLOWERCASE | V_YELLOWMAP, "Perfstats 4 is not available");
+			V_DrawThinString(80, 100, V_MONOSPACE | V_ALLOWLOWERCASE | V_YELLOWMAP, "for resolutions below 640x400.");
+		}
+		else
+		{
+			PS_DrawThinkerStats();
+		}
+	}
 }
 
 // remove and unallocate history from all metrics
@@ -847,10 +1321,12 @@ void PS_PerfStats_OnChange(void)
 {
 	if (cv_perfstats.value && cv_ps_samplesize.value > 1)
 		PS_ClearHistory();
+	PS_ResetThinkerTimes();
 }
 
 void PS_SampleSize_OnChange(void)
 {
 	if (cv_ps_samplesize.value > 1)
 		PS_ClearHistory();
+	PS_ResetThinkerTimes();
 }
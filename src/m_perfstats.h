@@ -43,16 +43,40 @@ extern ps_metric_t ps_thinkertime;
 extern ps_metric_t ps_thlist_times[];
 
 extern ps_metric_t ps_checkposition_calls;
+extern ps_metric_t ps_dormant_mobjs;
+extern ps_metric_t ps_thingpair_tests;
+extern ps_metric_t ps_sight_checks;
+extern ps_metric_t ps_sight_cachehits;
 
 extern ps_metric_t ps_lua_thinkframe_time;
 extern ps_metric_t ps_lua_mobjhooks;
 
+extern ps_metric_t ps_lua_gctime;
+extern ps_metric_t ps_lua_heapsize;
+extern ps_metric_t ps_lua_gccycles;
+
 extern ps_metric_t ps_otherlogictime;
 
 void PS_SetThinkFrameHookInfo(int index, precise_t time_taken, char* short_src);
 
+// Lua profiler, see Command_LuaProf_f
+typedef struct
+{
+	precise_t start;
+	precise_t outer; // time spent in nested calls of the enclosing call
+} ps_luaprofcall_t;
+
+extern boolean ps_luaprof_active;
+
+void PS_LuaProfEnter(ps_luaprofcall_t *call);
+void PS_LuaProfLeave(ps_luaprofcall_t *call, lua_State *L, const char *what);
+void Command_LuaProf_f(void);
+
 void PS_UpdateTickStats(void);
 
+void PS_RunTimedThinker(thinker_t *thinker);
+void Command_ThinkerDump_f(void);
+
 void M_DrawPerfStats(void);
 
 void PS_PerfStats_OnChange(void);
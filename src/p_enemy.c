@@ -2357,7 +2357,7 @@ void A_MonitorPop(void *thing)
 	remains = P_SpawnMobj(actor->x, actor->y,
 		((actor->eflags & MFE_VERTICALFLIP) ? (actor->z + actor->height - FixedMul(mobjinfo[actor->info->speed].height, actor->scale)) : actor->z),
 		actor->info->speed);
-	remains->type = actor->type; // Transfer type information
+	P_SetMobjType(remains, actor->type); // Transfer type information
 	P_UnsetThingPosition(remains);
 	if (sector_list)
 	{
@@ -2510,7 +2510,7 @@ void A_BossDeath(void *thing)
 
 	// scan the remaining thinkers to see
 	// if all bosses are dead
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -2567,7 +2567,7 @@ bossjustdie:
 
 		// Flee! Flee! Find a point to escape to! If none, just shoot upward!
 		// scan the thinkers to find the runaway point
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -3353,6 +3353,17 @@ void A_AttractChase(void *thing)
 	mobj_t *actor = thing;
 	if (LUA_CallAction("A_AttractChase", actor))
 		return;
+	P_AttractChase(actor);
+}
+
+//
+// P_AttractChase
+//
+// The body of A_AttractChase, for callers that already know
+// Lua hasn't replaced it (see P_IdleRingThinker).
+//
+void P_AttractChase(mobj_t *actor)
+{
 	if (actor->flags2 & MF2_NIGHTSPULL || !actor->health)
 		return;
 
@@ -4989,7 +5000,7 @@ void A_RingExplode(void *thing)
 
 	S_StartSound(actor, sfx_prloop);
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -6592,7 +6603,7 @@ void A_Boss3Path(void *thing)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -6971,7 +6982,7 @@ void A_FindTarget(void *thing)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTarget called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -7035,7 +7046,7 @@ void A_FindTracer(void *thing)
 	CONS_Debug(DBG_GAMELOGIC, "A_FindTracer called from object type %d, var1: %d, var2: %d\n", actor->type, locvar1, locvar2);
 
 	// scan the thinkers
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -7578,7 +7589,7 @@ void A_RemoteAction(void *thing)
 		fixed_t dist1 = 0, dist2 = 0;
 
 		// scan the thinkers
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -7793,7 +7804,7 @@ void A_SetObjectTypeState(void *thing)
 	if (LUA_CallAction("A_SetObjectTypeState", actor))
 		return;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -8413,7 +8424,7 @@ void A_CheckThingCount(void *thing)
 	if (LUA_CallAction("A_CheckThingCount", actor))
 		return;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -1963,7 +1963,7 @@ void T_ThwompSector(levelspecthink_t *thwomp)
 		if (!rover || (rover->flags & FF_EXISTS))
 		{
 			// scan the thinkers to find players!
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 			{
 				if (th->function != (actionf_p1)P_MobjThinker)
 					continue;
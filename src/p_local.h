@@ -39,6 +39,13 @@
 #define MAPBMASK      (MAPBLOCKSIZE-1)
 #define MAPBTOFRAC    (MAPBLOCKSHIFT-FRACBITS)
 
+// Things are linked into their own, finer grid over the same area
+// (blocklinks), so collision checks in crowded spots test fewer of them.
+// Each mapblock covers THINGBLOCKS*THINGBLOCKS thing blocks. The size is
+// a compile-time constant as it decides thing iteration order.
+#define THINGBLOCKSHIFT (FRACBITS+6)
+#define THINGBLOCKS     (1<<(MAPBLOCKSHIFT-THINGBLOCKSHIFT))
+
 // Convenience macro to fix issue with collision along bottom/left edges of blockmap -Red
 #define BMBOUNDFIX(xl, xh, yl, yh) {if (xl > xh) xl = 0; if (yl > yh) yl = 0;}
 
@@ -68,8 +75,33 @@
 extern thinker_t thinkercap;
 extern mobj_t *mobjcache;
 
+// Thinkers are also linked into one list per class, so code that only
+// cares about mobjs doesn't have to walk every sector special as well.
+// Execution order is still decided by thinkercap alone.
+typedef enum
+{
+	THINK_MAIN, // sector specials, polyobjects, anything else
+	THINK_MOBJ,
+	THINK_PRECIP,
+	NUM_THINKERLISTS
+} thinklistnum_t;
+
+// both the head and tail of each class list; walk with cnext/cprev
+extern thinker_t thlist[NUM_THINKERLISTS];
+
+// Every mobj in the thinker list is also in the list for its type, in
+// the order they joined it, until it is freed; walk with tnext. Like the
+// class lists these still hold removed mobjs, so check P_MobjWasRemoved.
+// Change a live mobj's type with P_SetMobjType to keep it in the right one.
+extern mobj_t *mobjtypelist[NUMMOBJTYPES];
+
 void P_InitThinkers(void);
 void P_AddThinker(thinker_t *thinker);
+void P_LinkThinkerClass(thinker_t *thinker, boolean front);
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type);
+void P_SortMobjTypeLists(void);
+boolean P_MobjIsDormant(mobj_t *mobj);
+void P_SetupIdleRings(void);
 void P_RemoveThinker(thinker_t *thinker);
 
 //
@@ -299,6 +331,7 @@ boolean P_CheckMissileRange(void *thing);
 
 void P_NewChaseDir(void *thing);
 boolean P_LookForPlayers(void *thing, boolean allaround, boolean tracer, fixed_t dist);
+void P_AttractChase(mobj_t *actor);
 
 //
 // P_MAP
@@ -338,6 +371,7 @@ boolean P_MoveOrigin(mobj_t *thing, fixed_t x, fixed_t y, fixed_t z);
 void P_SlideMove(mobj_t *mo);
 void P_BounceMove(mobj_t *mo);
 boolean P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_InvalidateSightCache(void);
 void P_CheckHoopPosition(mobj_t *hoopthing, fixed_t x, fixed_t y, fixed_t z, fixed_t radius);
 
 boolean P_CheckSector(sector_t *sector, boolean crunch);
@@ -363,6 +397,7 @@ extern INT32 *blockmaplump; // offsets in blockmap are from here
 extern INT32 *blockmap; // Big blockmap
 extern INT32 bmapwidth;
 extern INT32 bmapheight; // in mapblocks
+extern INT32 thingmapwidth, thingmapheight; // size of blocklinks, in thing blocks
 extern fixed_t bmaporgx;
 extern fixed_t bmaporgy; // origin of block map
 extern mobj_t **blocklinks; // for thing chains
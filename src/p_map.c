@@ -1466,10 +1466,17 @@ boolean P_CheckPosition(mobj_t *thing, fixed_t x, fixed_t y)
 	// MF_NOCLIPTHING: used by camera to not be blocked by things
 	if (!(thing->flags & MF_NOCLIPTHING))
 	{
-		for (bx = xl; bx <= xh; bx++)
-			for (by = yl; by <= yh; by++)
+		INT32 txl = (unsigned)(tmbbox[BOXLEFT] - bmaporgx - MAXRADIUS)>>THINGBLOCKSHIFT;
+		INT32 txh = (unsigned)(tmbbox[BOXRIGHT] - bmaporgx + MAXRADIUS)>>THINGBLOCKSHIFT;
+		INT32 tyl = (unsigned)(tmbbox[BOXBOTTOM] - bmaporgy - MAXRADIUS)>>THINGBLOCKSHIFT;
+		INT32 tyh = (unsigned)(tmbbox[BOXTOP] - bmaporgy + MAXRADIUS)>>THINGBLOCKSHIFT;
+
+		BMBOUNDFIX(txl, txh, tyl, tyh);
+
+		for (bx = txl; bx <= txh; bx++)
+			for (by = tyl; by <= tyh; by++)
 			{
-				if (!P_BlockThingsIterator(bx, by, PIT_CheckThing))
+				if (!P_ThingBlockIterator(bx, by, PIT_CheckThing))
 					blockval = false;
 				if (P_MobjWasRemoved(tmthing))
 					return false;
@@ -2018,10 +2025,10 @@ boolean P_TryMove(mobj_t *thing, fixed_t x, fixed_t y, boolean allowdropoff)
 	{
 		INT32 bx, by, xl, xh, yl, yh;
 
-		yh = (unsigned)(thing->y + MAXRADIUS - bmaporgy)>>MAPBLOCKSHIFT;
-		yl = (unsigned)(thing->y - MAXRADIUS - bmaporgy)>>MAPBLOCKSHIFT;
-		xh = (unsigned)(thing->x + MAXRADIUS - bmaporgx)>>MAPBLOCKSHIFT;
-		xl = (unsigned)(thing->x - MAXRADIUS - bmaporgx)>>MAPBLOCKSHIFT;
+		yh = (unsigned)(thing->y + MAXRADIUS - bmaporgy)>>THINGBLOCKSHIFT;
+		yl = (unsigned)(thing->y - MAXRADIUS - bmaporgy)>>THINGBLOCKSHIFT;
+		xh = (unsigned)(thing->x + MAXRADIUS - bmaporgx)>>THINGBLOCKSHIFT;
+		xl = (unsigned)(thing->x - MAXRADIUS - bmaporgx)>>THINGBLOCKSHIFT;
 
 		BMBOUNDFIX(xl, xh, yl, yh);
 
@@ -2031,7 +2038,7 @@ boolean P_TryMove(mobj_t *thing, fixed_t x, fixed_t y, boolean allowdropoff)
 
 		for (by = yl; by <= yh; by++)
 			for (bx = xl; bx <= xh; bx++)
-				P_BlockThingsIterator(bx, by, PIT_PushableMoved);
+				P_ThingBlockIterator(bx, by, PIT_PushableMoved);
 	}
 
 	// Link the thing into its new position
@@ -3163,10 +3170,10 @@ void P_RadiusAttack(mobj_t *spot, mobj_t *source, fixed_t damagedist)
 	fixed_t dist;
 
 	dist = FixedMul(damagedist, spot->scale) + MAXRADIUS;
-	yh = (unsigned)(spot->y + dist - bmaporgy)>>MAPBLOCKSHIFT;
-	yl = (unsigned)(spot->y - dist - bmaporgy)>>MAPBLOCKSHIFT;
-	xh = (unsigned)(spot->x + dist - bmaporgx)>>MAPBLOCKSHIFT;
-	xl = (unsigned)(spot->x - dist - bmaporgx)>>MAPBLOCKSHIFT;
+	yh = (unsigned)(spot->y + dist - bmaporgy)>>THINGBLOCKSHIFT;
+	yl = (unsigned)(spot->y - dist - bmaporgy)>>THINGBLOCKSHIFT;
+	xh = (unsigned)(spot->x + dist - bmaporgx)>>THINGBLOCKSHIFT;
+	xl = (unsigned)(spot->x - dist - bmaporgx)>>THINGBLOCKSHIFT;
 
 	BMBOUNDFIX(xl, xh, yl, yh);
 
@@ -3176,7 +3183,7 @@ void P_RadiusAttack(mobj_t *spot, mobj_t *source, fixed_t damagedist)
 
 	for (y = yl; y <= yh; y++)
 		for (x = xl; x <= xh; x++)
-			P_BlockThingsIterator(x, y, PIT_RadiusAttack);
+			P_ThingBlockIterator(x, y, PIT_RadiusAttack);
 }
 
 //
@@ -3195,6 +3202,11 @@ void P_RadiusAttack(mobj_t *spot, mobj_t *source, fixed_t damagedist)
 static boolean crushchange;
 static boolean nofit;
 
+// Bumped whenever a sector's touching_thinglist is relinked, or its
+// visited marks are reset, so P_ChangeSectorThings knows when it can't
+// carry on from where it was.
+static UINT32 secnodechanges;
+
 //
 // PIT_ChangeSector
 //
@@ -3261,7 +3273,7 @@ static boolean PIT_ChangeSector(mobj_t *thing, boolean realcrush)
 						thinker_t *think;
 						elevator_t *crumbler;
 
-						for (think = thinkercap.next; think != &thinkercap; think = think->next)
+						for (think = thlist[THINK_MAIN].cnext; think != &thlist[THINK_MAIN]; think = think->cnext)
 						{
 							if (think->function != (actionf_p1)T_StartCrumble)
 								continue;
@@ -3308,6 +3320,46 @@ static boolean PIT_ChangeSector(mobj_t *thing, boolean realcrush)
 	return true;
 }
 
+//
+// P_ChangeSectorThings
+//
+// Runs the non-crushing PIT_ChangeSector pass over every thing touching
+// sec, in list order, and returns false as soon as one doesn't fit.
+//
+static boolean P_ChangeSectorThings(sector_t *sec)
+{
+	msecnode_t *n;
+	UINT32 changes;
+
+	for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
+		n->visited = false;
+
+	n = sec->touching_thinglist;
+	while (n)
+	{
+		if (n->visited)
+		{
+			n = n->m_thinglist_next;
+			continue;
+		}
+
+		n->visited = true; // mark thing as processed
+		changes = secnodechanges;
+
+		if (!(n->m_thing->flags & MF_NOBLOCKMAP) //jff 4/7/98 don't do these
+			&& !PIT_ChangeSector(n->m_thing, false))
+			return false;
+
+		// killough 4/4/98 restarted from the head after every thing, which
+		// is quadratic in the number of things. Only do that when the list
+		// or its marks actually changed under us; otherwise the first
+		// unvisited node is the one after this.
+		n = (secnodechanges == changes) ? n->m_thinglist_next : sec->touching_thinglist;
+	}
+
+	return true;
+}
+
 //
 // P_CheckSector
 //
@@ -3318,6 +3370,9 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 
 	nofit = false;
 	crushchange = crunch;
+	secnodechanges++; // we may be nested inside another check's loop
+
+	P_InvalidateSightCache(); // sector planes have moved
 
 	// killough 4/4/98: scan list front-to-back until empty or exhausted,
 	// restarting from beginning after each thing is processed. Avoids
@@ -3348,16 +3403,16 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 				INT32 x, y;
 				po->validcount = validcount;
 
-				for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
+				for (y = po->blockbox[BOXBOTTOM]*THINGBLOCKS; y < (po->blockbox[BOXTOP]+1)*THINGBLOCKS; ++y)
 				{
-					for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
+					for (x = po->blockbox[BOXLEFT]*THINGBLOCKS; x < (po->blockbox[BOXRIGHT]+1)*THINGBLOCKS; ++x)
 					{
 						mobj_t *mo;
 
-						if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+						if (x < 0 || y < 0 || x >= thingmapwidth || y >= thingmapheight)
 							continue;
 
-						mo = blocklinks[y * bmapwidth + x];
+						mo = blocklinks[y * thingmapwidth + x];
 
 						for (; mo; mo = mo->bnext)
 						{
@@ -3384,8 +3439,6 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 		for (i = 0; i < sector->numattached; i++)
 		{
 			sec = &sectors[sector->attached[i]];
-			for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				n->visited = false;
 
 			sec->moved = true;
 
@@ -3394,51 +3447,25 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 			if (!sector->attachedsolid[i])
 				continue;
 
-			do
+			if (!P_ChangeSectorThings(sec))
 			{
-				for (n = sec->touching_thinglist; n; n = n->m_thinglist_next)
-				if (!n->visited)
-				{
-					n->visited = true;
-					if (!(n->m_thing->flags & MF_NOBLOCKMAP))
-					{
-						if (!PIT_ChangeSector(n->m_thing, false))
-						{
-							nofit = true;
-							return nofit;
-						}
-					}
-					break;
-				}
-			} while (n);
+				nofit = true;
+				return nofit;
+			}
 		}
 	}
 
 	// Mark all things invalid
 	sector->moved = true;
 
-	for (n = sector->touching_thinglist; n; n = n->m_thinglist_next)
-		n->visited = false;
-
-	do
+	if (!P_ChangeSectorThings(sector))
 	{
-		for (n = sector->touching_thinglist; n; n = n->m_thinglist_next) // go through list
-			if (!n->visited) // unprocessed thing found
-			{
-				n->visited = true; // mark thing as processed
-				if (!(n->m_thing->flags & MF_NOBLOCKMAP)) //jff 4/7/98 don't do these
-				{
-					if (!PIT_ChangeSector(n->m_thing, false)) // process it
-					{
-						nofit = true;
-						return nofit;
-					}
-				}
-				break; // exit and start over
-			}
-	} while (n); // repeat from scratch until all things left are marked valid
+		nofit = true;
+		return nofit;
+	}
 
 	// Nothing blocked us, so lets crush for real!
+	secnodechanges++;
 
 	// Sal: This stupid function chain is required to fix polyobjects not being able to crush.
 	// Monster Iestyn: don't use P_CheckSector actually just look for objects in the blockmap instead
@@ -3458,16 +3485,16 @@ boolean P_CheckSector(sector_t *sector, boolean crunch)
 				INT32 x, y;
 				po->validcount = validcount;
 
-				for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
+				for (y = po->blockbox[BOXBOTTOM]*THINGBLOCKS; y < (po->blockbox[BOXTOP]+1)*THINGBLOCKS; ++y)
 				{
-					for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
+					for (x = po->blockbox[BOXLEFT]*THINGBLOCKS; x < (po->blockbox[BOXRIGHT]+1)*THINGBLOCKS; ++x)
 					{
 						mobj_t *mo;
 
-						if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+						if (x < 0 || y < 0 || x >= thingmapwidth || y >= thingmapheight)
 							continue;
 
-						mo = blocklinks[y * bmapwidth + x];
+						mo = blocklinks[y * thingmapwidth + x];
 
 						for (; mo; mo = mo->bnext)
 						{
@@ -3628,6 +3655,7 @@ static msecnode_t *P_AddSecnode(sector_t *s, mobj_t *thing, msecnode_t *nextnode
 
 	// mark new nodes unvisited.
 	node->visited = 0;
+	secnodechanges++;
 
 	node->m_sector = s; // sector
 	node->m_thing = thing; // mobj
@@ -3722,6 +3750,7 @@ static msecnode_t *P_DelSecnode(msecnode_t *node)
 		node->m_sector->touching_thinglist = sn;
 	if (sn)
 		sn->m_thinglist_prev = sp;
+	secnodechanges++;
 
 	// Return this node to the freelist
 
@@ -22,6 +22,7 @@
 #include "p_polyobj.h"
 #include "p_slopes.h"
 #include "z_zone.h"
+#include "m_perfstats.h"
 
 //
 // P_AproxDistance
@@ -833,16 +834,16 @@ void P_SetThingPosition(mobj_t *thing)
 	if (!(thing->flags & MF_NOBLOCKMAP))
 	{
 		// inert things don't need to be in blockmap
-		const INT32 blockx = (unsigned)(thing->x - bmaporgx)>>MAPBLOCKSHIFT;
-		const INT32 blocky = (unsigned)(thing->y - bmaporgy)>>MAPBLOCKSHIFT;
-		if (blockx >= 0 && blockx < bmapwidth
-			&& blocky >= 0 && blocky < bmapheight)
+		const INT32 blockx = (unsigned)(thing->x - bmaporgx)>>THINGBLOCKSHIFT;
+		const INT32 blocky = (unsigned)(thing->y - bmaporgy)>>THINGBLOCKSHIFT;
+		if (blockx >= 0 && blockx < thingmapwidth
+			&& blocky >= 0 && blocky < thingmapheight)
 		{
 			// killough 8/11/98: simpler scheme using
 			// pointer-to-pointer prev pointers --
 			// allows head nodes to be treated like everything else
 
-			mobj_t **link = &blocklinks[blocky*bmapwidth + blockx];
+			mobj_t **link = &blocklinks[blocky*thingmapwidth + blockx];
 			mobj_t *bnext = *link;
 			if ((thing->bnext = bnext) != NULL)
 				bnext->bprev = &thing->bnext;
@@ -992,19 +993,23 @@ boolean P_BlockLinesIterator(INT32 x, INT32 y, boolean (*func)(line_t *))
 
 
 //
-// P_BlockThingsIterator
+// P_ThingBlockIterator
 //
-boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
+// Like P_BlockThingsIterator, but x and y are thing block coordinates
+// (THINGBLOCKSHIFT) rather than mapblock ones.
+//
+boolean P_ThingBlockIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 {
 	mobj_t *mobj, *bnext = NULL;
 
-	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+	if (x < 0 || y < 0 || x >= thingmapwidth || y >= thingmapheight)
 		return true;
 
 	// Check interaction with the objects in the blockmap.
-	for (mobj = blocklinks[y*bmapwidth + x]; mobj; mobj = bnext)
+	for (mobj = blocklinks[y*thingmapwidth + x]; mobj; mobj = bnext)
 	{
 		P_SetTarget(&bnext, mobj->bnext); // We want to note our reference to bnext here incase it is MF_NOTHINK and gets removed!
+		ps_thingpair_tests.value.i++;
 		if (!func(mobj))
 			return false;
 		if (P_MobjWasRemoved(tmthing) // func just popped our tmthing, cannot continue.
@@ -1017,6 +1022,25 @@ boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
 	return true;
 }
 
+//
+// P_BlockThingsIterator
+//
+// Visits every thing block inside mapblock x, y.
+//
+boolean P_BlockThingsIterator(INT32 x, INT32 y, boolean (*func)(mobj_t *))
+{
+	INT32 bx, by;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return true;
+
+	for (by = y*THINGBLOCKS; by < (y+1)*THINGBLOCKS; by++)
+		for (bx = x*THINGBLOCKS; bx < (x+1)*THINGBLOCKS; bx++)
+			if (!P_ThingBlockIterator(bx, by, func))
+				return false;
+	return true;
+}
+
 //
 // INTERCEPT ROUTINES
 //
@@ -506,7 +506,7 @@ void P_EmeraldManager(void)
 		spawnpoints[i] = NULL;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].cnext; think != &thlist[THINK_MOBJ]; think = think->cnext)
 	{
 		if (think->function != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3398,7 +3398,7 @@ void P_DestroyRobots(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].cnext; think != &thlist[THINK_MOBJ]; think = think->cnext)
 	{
 		if (think->function != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -3769,12 +3769,13 @@ void P_RecalcPrecipInSector(sector_t *sector)
 //
 // P_NullPrecipThinker
 //
-// For "Blank" precipitation
+// Never actually called: precipitation is only linked into
+// thlist[THINK_PRECIP], and the renderer moves visible drops along with
+// P_RainThinker/P_SnowThinker. It just marks the thinker as precipitation.
 //
 void P_NullPrecipThinker(precipmobj_t *mobj)
 {
-	//(void)mobj;
-	mobj->precipflags &= ~PCF_THUNK;
+	(void)mobj;
 }
 
 void P_SnowThinker(precipmobj_t *mobj)
@@ -4196,7 +4197,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 
 			// scan the thinkers to make sure all the old pinch dummies are gone before making new ones
 			// this can happen if the boss was hurt earlier than expected
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
+			for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 			{
 				if (th->function != (actionf_p1)P_MobjThinker)
 					continue;
@@ -4287,7 +4288,7 @@ static void P_Boss3Thinker(mobj_t *mobj)
 		// scan the thinkers
 		// to find a point that matches
 		// the number
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -4908,7 +4909,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 				closestdist = 16384*FRACUNIT; // Just in case...
 
 				// Find waypoint he is closest to
-				for (th = thinkercap.next; th != &thinkercap; th = th->next)
+				for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 				{
 					if (th->function != (actionf_p1)P_MobjThinker)
 						continue;
@@ -4963,7 +4964,7 @@ static void P_Boss7Thinker(mobj_t *mobj)
 
 		// scan the thinkers to find
 		// the waypoint to use
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5086,7 +5087,7 @@ static void P_Boss9Thinker(mobj_t *mobj)
 
 		// Run through the thinkers ONCE and find all of the MT_BOSS9GATHERPOINT in the map.
 		// Build a hoop linked list of 'em!
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
@@ -5520,7 +5521,7 @@ mobj_t *P_GetClosestAxis(mobj_t *source)
 	fixed_t dist1, dist2 = 0;
 
 	// scan the thinkers to find the closest axis point
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -6118,6 +6119,48 @@ static void P_KoopaThinker(mobj_t *koopa)
 	}
 }
 
+//
+// Idle rings
+//
+// Placed rings spend nearly all their time sitting still, and for those the
+// whole of P_MobjThinker boils down to animating and polling for attraction
+// shields. Once per tic, P_SetupIdleRings works out whether Lua could change
+// that for each ring type (a MobjThinker hook, or a replaced A_AttractChase).
+// If not, rings that nothing has moved, grabbed or pulled take the short path
+// below, with exactly the same result as the full one.
+//
+static const mobjtype_t idleringtypes[] = {MT_RING, MT_COIN, MT_BLUEBALL, MT_REDTEAMRING, MT_BLUETEAMRING};
+static boolean idleringok[NUMMOBJTYPES];
+
+void P_SetupIdleRings(void)
+{
+	const boolean luaattract = LUA_HasAction("A_ATTRACTCHASE");
+	size_t i;
+
+	for (i = 0; i < sizeof (idleringtypes) / sizeof (idleringtypes[0]); i++)
+		idleringok[idleringtypes[i]] = (!luaattract && !LUAh_MobjThinkerAvailable(idleringtypes[i]));
+}
+
+static boolean P_IdleRingThinker(mobj_t *mobj)
+{
+	if (mobj->momx || mobj->momy || mobj->momz || mobj->tics != -1
+	|| mobj->target || mobj->tracer || mobj->player || mobj->health <= 0
+	|| mobj->scale != mobj->destscale
+	|| (mobj->flags & (MF_SCENERY|MF_PUSHABLE|MF_BOSS)) || (mobj->info->flags & MF_PUSHABLE)
+	|| (mobj->flags2 & MF2_NIGHTSPULL)
+	|| (mobj->subsector && GETSECSPECIAL(mobj->subsector->sector->special, 2) == 8))
+		return false;
+
+	// What P_MobjThinker, P_RingThinker and A_AttractChase would still do
+	mobj->flags2 &= ~MF2_PUSHED;
+	mobj->eflags &= ~MFE_SPRUNG;
+	tmfloorthing = tmhitthing = NULL;
+
+	P_CycleStateAnimation(mobj);
+	P_AttractChase(mobj);
+	return true;
+}
+
 //
 // P_MobjThinker
 //
@@ -6135,6 +6178,16 @@ void P_MobjThinker(mobj_t *mobj)
 	if (mobj->tracer && P_MobjWasRemoved(mobj->tracer))
 		P_SetTarget(&mobj->tracer, NULL);
 
+	// Too far from everyone to matter; pick up where we left off later.
+	if (P_MobjIsDormant(mobj))
+	{
+		ps_dormant_mobjs.value.i++;
+		return;
+	}
+
+	if (idleringok[mobj->type] && P_IdleRingThinker(mobj))
+		return;
+
 	mobj->flags2 &= ~MF2_PUSHED;
 	mobj->eflags &= ~MFE_SPRUNG;
 
@@ -7571,24 +7624,58 @@ void P_SceneryThinker(mobj_t *mobj)
 //
 
 //
-// P_SpawnMobj
+// Mobj pool
 //
-mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+// Mobjs are carved out of PU_LEVEL chunks, so ones spawned together (which
+// also think one after another) sit next to each other in memory. Removed
+// mobjs go on mobjcache, linked by hnext, and are handed out again first.
+//
+#define MOBJCHUNKSIZE 256
+
+static mobj_t *mobjchunk;
+static size_t mobjchunkleft;
+
+// Called when PU_LEVEL is purged.
+void P_InitMobjPool(void)
+{
+	mobjcache = mobjchunk = NULL;
+	mobjchunkleft = 0;
+}
+
+// Returns a zeroed mobj.
+mobj_t *P_AllocMobj(void)
 {
-	const mobjinfo_t *info = &mobjinfo[type];
-	state_t *st;
 	mobj_t *mobj;
+
 	if (mobjcache != NULL)
 	{
 		mobj = mobjcache;
 		mobjcache = mobjcache->hnext;
-		memset(mobj, 0, sizeof(*mobj));
 	}
 	else
 	{
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		if (!mobjchunkleft)
+		{
+			mobjchunk = Z_Malloc(MOBJCHUNKSIZE * sizeof (*mobjchunk), PU_LEVEL, NULL);
+			mobjchunkleft = MOBJCHUNKSIZE;
+		}
+		mobj = mobjchunk++;
+		mobjchunkleft--;
 	}
 
+	memset(mobj, 0, sizeof (*mobj));
+	return mobj;
+}
+
+//
+// P_SpawnMobj
+//
+mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
+{
+	const mobjinfo_t *info = &mobjinfo[type];
+	state_t *st;
+	mobj_t *mobj = P_AllocMobj();
+
 	// this is officially a mobj, declared as soon as possible.
 	mobj->thinker.function = (actionf_p1)P_MobjThinker;
 	mobj->type = type;
@@ -7823,10 +7910,54 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 	return mobj;
 }
 
+//
+// Precipitation pool
+//
+// Weather maps spawn thousands of drops, so rather than giving each one its
+// own zone block, they're carved out of PU_LEVEL chunks and recycled through
+// a free list linked by thinker.cnext.
+//
+#define PRECIPCHUNKSIZE 512
+
+static precipmobj_t *precipfreelist;
+static precipmobj_t *precipchunk;
+static size_t precipchunkleft;
+
+// Called when PU_LEVEL is purged.
+void P_InitPrecipPool(void)
+{
+	precipfreelist = precipchunk = NULL;
+	precipchunkleft = 0;
+}
+
+static precipmobj_t *P_AllocPrecipMobj(void)
+{
+	precipmobj_t *mobj;
+
+	if (precipfreelist)
+	{
+		mobj = precipfreelist;
+		precipfreelist = (precipmobj_t *)mobj->thinker.cnext;
+	}
+	else
+	{
+		if (!precipchunkleft)
+		{
+			precipchunk = Z_Malloc(PRECIPCHUNKSIZE * sizeof (*precipchunk), PU_LEVEL, NULL);
+			precipchunkleft = PRECIPCHUNKSIZE;
+		}
+		mobj = precipchunk++;
+		precipchunkleft--;
+	}
+
+	memset(mobj, 0, sizeof (*mobj));
+	return mobj;
+}
+
 static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type)
 {
 	state_t *st;
-	precipmobj_t *mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+	precipmobj_t *mobj = P_AllocPrecipMobj();
 	fixed_t starting_floorz;
 
 	mobj->x = x;
@@ -7852,8 +7983,10 @@ static precipmobj_t *P_SpawnPrecipMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype
 	mobj->z = z;
 	mobj->momz = mobjinfo[type].speed;
 
+	// Only the class list: there's nothing for P_RunThinkers to do
 	mobj->thinker.function = (actionf_p1)P_NullPrecipThinker;
-	P_AddThinker(&mobj->thinker);
+	P_LinkThinkerClass(&mobj->thinker, false);
+	mobj->thinktic = leveltime - 1;
 
 	CalculatePrecipFloor(mobj);
 
@@ -7994,8 +8127,13 @@ void P_RemovePrecipMobj(precipmobj_t *mobj)
 		precipsector_list = NULL;
 	}
 
-	// free block
-	P_RemoveThinker((thinker_t *)mobj);
+	// Unlink from thlist[THINK_PRECIP] and recycle. The renderer may be
+	// removing us from inside its sector walk, so snext must stay intact.
+	mobj->thinker.cnext->cprev = mobj->thinker.cprev;
+	mobj->thinker.cprev->cnext = mobj->thinker.cnext;
+	mobj->thinker.function = NULL;
+	mobj->thinker.cnext = (thinker_t *)precipfreelist;
+	precipfreelist = mobj;
 }
 
 // Clearing out stuff for savegames
@@ -9196,7 +9334,7 @@ ML_NOCLIMB : Direction not controllable
 		mobj->health = (mthing->angle / 360) + 1;
 
 		// See if other starposts exist in this level that have the same value.
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
+		for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 		{
 			if (th->function != (actionf_p1)P_MobjThinker)
 				continue;
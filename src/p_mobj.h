@@ -254,8 +254,6 @@ typedef enum {
 	PCF_MOVINGFOF = 8,
 	// Is rain.
 	PCF_RAIN = 16,
-	// Ran the thinker this tic.
-	PCF_THUNK = 32,
 } precipflag_t;
 // Map Object definition.
 typedef struct mobj_s
@@ -299,61 +297,80 @@ typedef struct mobj_s
 	INT32 tics; // state tic counter
 	state_t *state;
 	UINT32 flags; // flags from mobjinfo tables
+	// Everything above is shared with precipmobj_t.
+
+	// The rest of the fields the thinker, collision and renderer go
+	// through every tic follow straight on, so an object's hot data
+	// stays within its first few cache lines. Keep it that way: rarely
+	// used fields go in the second half.
 	UINT32 flags2; // MF2_ flags
 	UINT16 eflags; // extra flags
 
-	void *skin; // overrides 'sprite' when non-NULL (for player bodies to 'remember' the skin)
-	// Player and mobj sprites in multiplayer modes are modified
-	//  using an internal color lookup table for re-indexing.
-	UINT8 color; // This replaces MF_TRANSLATION. Use 0 for default (no translation).
-
 	// Interaction info, by BLOCKMAP.
 	// Links in blocks (if needed).
 	struct mobj_s *bnext;
 	struct mobj_s **bprev; // killough 8/11/98: change to ptr-to-ptr
 
-	// Additional pointers for NiGHTS hoops
-	struct mobj_s *hnext;
-	struct mobj_s *hprev;
-
 	mobjtype_t type;
 	const mobjinfo_t *info; // &mobjinfo[mobj->type]
 
 	INT32 health; // for player this is rings + 1
 
-	// Movement direction, movement generation (zig-zagging).
-	angle_t movedir; // dirtype_t 0-7; also used by Deton for up/down angle
-	INT32 movecount; // when 0, select a new dir
+	INT32 fuse; // Does something in P_MobjThinker on reaching 0.
 
 	struct mobj_s *target; // Thing being chased/attacked (or NULL), and originator for missiles.
-
-	INT32 reactiontime; // If not 0, don't attack yet.
-
-	INT32 threshold; // If >0, the target will be chased no matter what.
+	struct mobj_s *tracer; // Thing being chased/attacked for tracers.
 
 	// Additional info record for player avatars only.
 	// Only valid if type == MT_PLAYER
 	struct player_s *player;
 
-	INT32 lastlook; // Player number last looked for.
-
-	mapthing_t *spawnpoint; // Used for CTF flags, objectplace, and a handful other applications.
-
-	struct mobj_s *tracer; // Thing being chased/attacked for tracers.
+	fixed_t scale;
+	fixed_t destscale;
 
 	fixed_t friction;
 	fixed_t movefactor;
 
-	INT32 fuse; // Does something in P_MobjThinker on reaching 0.
 	fixed_t watertop; // top of the water FOF the mobj is in
 	fixed_t waterbottom; // bottom of the water FOF the mobj is in
 
+	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
+
+	// Movement direction, movement generation (zig-zagging).
+	angle_t movedir; // dirtype_t 0-7; also used by Deton for up/down angle
+	INT32 movecount; // when 0, select a new dir
+
+	INT32 reactiontime; // If not 0, don't attack yet.
+
+	INT32 threshold; // If >0, the target will be chased no matter what.
+
+	// Cold fields from here on.
+
+	void *skin; // overrides 'sprite' when non-NULL (for player bodies to 'remember' the skin)
+	// Player and mobj sprites in multiplayer modes are modified
+	//  using an internal color lookup table for re-indexing.
+	UINT8 color; // This replaces MF_TRANSLATION. Use 0 for default (no translation).
+
+	boolean resetinterp; // if true, some fields should not be interpolated (see R_InterpolateMobjState implementation)
+
+	// Additional pointers for NiGHTS hoops
+	struct mobj_s *hnext;
+	struct mobj_s *hprev;
+
+	// Links in the list of thinking mobjs of this type (mobjtypelist),
+	// rebuilt on load rather than saved, and the position in it
+	struct mobj_s *tnext;
+	struct mobj_s **tprev;
+	UINT32 tseq;
+
+	INT32 lastlook; // Player number last looked for.
+
+	mapthing_t *spawnpoint; // Used for CTF flags, objectplace, and a handful other applications.
+
 	UINT32 mobjnum; // A unique number for this mobj. Used for restoring pointers on save games.
 
-	fixed_t scale;
 	fixed_t old_scale; // interpolation
 	fixed_t old_scale2;
-	fixed_t destscale;
 	fixed_t scalespeed;
 
 	// Extra values are for internal use for whatever you want
@@ -365,11 +382,6 @@ typedef struct mobj_s
 	INT32 cusval;
 	INT32 cvmem;
 
-
-	struct pslope_s *standingslope; // The slope that the object is standing on (shouldn't need synced in savegames, right?)
-
-	boolean resetinterp; // if true, some fields should not be interpolated (see R_InterpolateMobjState implementation)
-
 	// WARNING: New fields must be added separately to savegame and Lua.
 } mobj_t;
 
@@ -421,6 +433,8 @@ typedef struct precipmobj_s
 	INT32 tics; // state tic counter
 	state_t *state;
 	INT32 flags; // flags from mobjinfo tables
+
+	tic_t thinktic; // last tic the renderer moved this along
 } precipmobj_t;
 
 typedef struct actioncache_s
@@ -458,6 +472,9 @@ void P_SnowThinker(precipmobj_t *mobj);
 void P_RainThinker(precipmobj_t *mobj);
 void P_NullPrecipThinker(precipmobj_t *mobj);
 void P_RemovePrecipMobj(precipmobj_t *mobj);
+void P_InitMobjPool(void);
+mobj_t *P_AllocMobj(void);
+void P_InitPrecipPool(void);
 void P_SetScale(mobj_t *mobj, fixed_t newscale);
 void P_XYMovement(mobj_t *mo);
 void P_EmeraldManager(void);
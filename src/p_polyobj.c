@@ -150,6 +150,7 @@ FUNCINLINE static ATTRINLINE void PolyObj_AddThinker(thinker_t *th)
 	th->next = thinkercap.next;
 	th->prev = &thinkercap;
 	thinkercap.next = th;
+	P_LinkThinkerClass(th, true);
 	th->references = 0;
 
 	th->cachable = false;
@@ -772,6 +773,7 @@ static void Polyobj_attachToSubsec(polyobj_t *po)
 	ss = R_PointInSubsector(po->centerPt.x, po->centerPt.y);
 
 	M_DLListInsert(&po->link, (mdllistitem_t **)(void *)(&ss->polyList));
+	po->subsector = ss;
 
 #ifdef R_LINKEDPORTALS
 	// set spawnSpot's groupid for correct portal sound behavior
@@ -833,22 +835,14 @@ static void Polyobj_putLink(polymaplink_t *l)
 }
 
 //
-// Polyobj_linkToBlockmap
+// Polyobj_getBlockbox
 //
-// Inserts a polyobject into the polyobject blockmap. Unlike, mobj_t's,
-// polyobjects need to be linked into every blockmap cell which their
-// bounding box intersects. This ensures the accurate level of clipping
-// which is present with linedefs but absent from most mobj interactions.
+// Works out which blockmap cells the polyobject's bounding box covers,
+// from its current vertices.
 //
-static void Polyobj_linkToBlockmap(polyobj_t *po)
+static void Polyobj_getBlockbox(polyobj_t *po, fixed_t *blockbox)
 {
-	fixed_t *blockbox = po->blockbox;
 	size_t i;
-	fixed_t x, y;
-
-	// never link a bad polyobject or a polyobject already linked
-	if (po->isBad || po->linked)
-		return;
 
 	// 2/26/06: start line box with values of first vertex, not INT32_MIN/INT32_MAX
 	blockbox[BOXLEFT]   = blockbox[BOXRIGHT] = po->vertices[0]->x;
@@ -863,69 +857,128 @@ static void Polyobj_linkToBlockmap(polyobj_t *po)
 	blockbox[BOXLEFT]   = (unsigned)(blockbox[BOXLEFT]   - bmaporgx) >> MAPBLOCKSHIFT;
 	blockbox[BOXTOP]    = (unsigned)(blockbox[BOXTOP]    - bmaporgy) >> MAPBLOCKSHIFT;
 	blockbox[BOXBOTTOM] = (unsigned)(blockbox[BOXBOTTOM] - bmaporgy) >> MAPBLOCKSHIFT;
+}
 
-	// link polyobject to every block its bounding box intersects
-	for (y = blockbox[BOXBOTTOM]; y <= blockbox[BOXTOP]; ++y)
-	{
-		for (x = blockbox[BOXLEFT]; x <= blockbox[BOXRIGHT]; ++x)
-		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
-			{
-				polymaplink_t  *l = Polyobj_getLink();
+//
+// Polyobj_linkToCell
+//
+// Links a polyobject into a single blockmap cell.
+//
+static void Polyobj_linkToCell(polyobj_t *po, INT32 x, INT32 y)
+{
+	polymaplink_t *l;
 
-				l->po = po;
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return;
 
-				M_DLListInsert(&l->link,
-							(mdllistitem_t **)(&polyblocklinks[y*bmapwidth + x]));
-			}
-		}
-	}
+	l = Polyobj_getLink();
+	l->po = po;
 
-	po->linked = true;
+	M_DLListInsert(&l->link,
+				(mdllistitem_t **)(&polyblocklinks[y*bmapwidth + x]));
 }
 
 //
-// Polyobj_removeFromBlockmap
+// Polyobj_removeFromCell
 //
-// Unlinks a polyobject from all blockmap cells it intersects and returns
-// its polymaplink objects to the free list.
+// Unlinks a polyobject from a single blockmap cell, if it is there, and
+// returns the link to the free list.
 //
-static void Polyobj_removeFromBlockmap(polyobj_t *po)
+static void Polyobj_removeFromCell(polyobj_t *po, INT32 x, INT32 y)
 {
 	polymaplink_t *rover;
+
+	if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
+		return;
+
+	rover = polyblocklinks[y * bmapwidth + x];
+
+	while (rover && rover->po != po)
+		rover = (polymaplink_t *)(rover->link.next);
+
+	// polyobject not in this cell? go on to next.
+	if (!rover)
+		return;
+
+	// remove this link from the blockmap and put it on the freelist
+	M_DLListRemove(&rover->link);
+	Polyobj_putLink(rover);
+}
+
+#define BLOCKBOXHAS(box, x, y) ((x) >= (box)[BOXLEFT] && (x) <= (box)[BOXRIGHT] \
+	&& (y) >= (box)[BOXBOTTOM] && (y) <= (box)[BOXTOP])
+
+//
+// Polyobj_linkToBlockmap
+//
+// Inserts a polyobject into the polyobject blockmap. Unlike, mobj_t's,
+// polyobjects need to be linked into every blockmap cell which their
+// bounding box intersects. This ensures the accurate level of clipping
+// which is present with linedefs but absent from most mobj interactions.
+//
+static void Polyobj_linkToBlockmap(polyobj_t *po)
+{
 	fixed_t *blockbox = po->blockbox;
-	INT32 x, y;
+	fixed_t x, y;
 
-	// don't bother trying to unlink one that's not linked
-	if (!po->linked)
+	// never link a bad polyobject or a polyobject already linked
+	if (po->isBad || po->linked)
 		return;
 
-	// search all cells the polyobject touches
+	Polyobj_getBlockbox(po, blockbox);
+
+	// link polyobject to every block its bounding box intersects
 	for (y = blockbox[BOXBOTTOM]; y <= blockbox[BOXTOP]; ++y)
-	{
 		for (x = blockbox[BOXLEFT]; x <= blockbox[BOXRIGHT]; ++x)
-		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
-			{
-				rover = polyblocklinks[y * bmapwidth + x];
+			Polyobj_linkToCell(po, x, y);
 
-				while (rover && rover->po != po)
-					rover = (polymaplink_t *)(rover->link.next);
+	po->linked = true;
+}
 
-				// polyobject not in this cell? go on to next.
-				if (!rover)
-					continue;
+//
+// Polyobj_relinkBlockmap
+//
+// Moves a linked polyobject's blockmap links to match its vertices after
+// it has moved. Only the cells it has left or entered are touched, so most
+// steps of a moving or rotating polyobject change nothing at all.
+//
+static void Polyobj_relinkBlockmap(polyobj_t *po)
+{
+	fixed_t *oldbox = po->blockbox;
+	fixed_t newbox[4];
+	INT32 x, y;
 
-				// remove this link from the blockmap and put it on the freelist
-				M_DLListRemove(&rover->link);
-				Polyobj_putLink(rover);
-			}
-		}
+	if (po->isBad)
+		return;
+
+	if (!po->linked)
+	{
+		Polyobj_linkToBlockmap(po);
+		return;
 	}
 
-	po->linked = false;
+	Polyobj_getBlockbox(po, newbox);
+
+	if (!memcmp(oldbox, newbox, sizeof (newbox)))
+		return;
+
+	// leave the cells only the old box covers...
+	for (y = oldbox[BOXBOTTOM]; y <= oldbox[BOXTOP]; ++y)
+		for (x = oldbox[BOXLEFT]; x <= oldbox[BOXRIGHT]; ++x)
+			if (!BLOCKBOXHAS(newbox, x, y))
+				Polyobj_removeFromCell(po, x, y);
+
+	// ...and enter the ones only the new box covers
+	for (y = newbox[BOXBOTTOM]; y <= newbox[BOXTOP]; ++y)
+		for (x = newbox[BOXLEFT]; x <= newbox[BOXRIGHT]; ++x)
+			if (!BLOCKBOXHAS(oldbox, x, y))
+				Polyobj_linkToCell(po, x, y);
+
+	M_Memcpy(oldbox, newbox, sizeof (newbox));
 }
 
+#undef BLOCKBOXHAS
+
 // Movement functions
 
 //
@@ -1018,6 +1071,95 @@ static void Polyobj_slideThing(mobj_t *mo, fixed_t dx, fixed_t dy)
 		P_TryMove(mo, mo->x+dx, mo->y+dy, true);
 }
 
+//
+// Polyobj_gatherThings
+//
+// Collects every thing that a move of the polyobject could clip or carry:
+// all things linked into the thing blocks under its bounding box, extended
+// by MAXRADIUS. This is done once per move, after the vertices have been
+// moved, and shared by Polyobj_clipThings and the carrying functions so
+// each line doesn't walk the blocks again. Each thing is referenced until
+// Polyobj_releaseThings, so one removed mid-move can't be reused.
+//
+// The current move's things are pothings[pothingsbase..numpothings-1].
+// Sets stack up in case pushing something moves another polyobject.
+// Returns the previous base, to hand back to Polyobj_releaseThings.
+//
+// This is not quite what the old per-walk code did, and that shows at the
+// edges. Carrying used to walk the live blocks under the old blockbox;
+// now it uses this snapshot of the new box plus MAXRADIUS, taken before
+// clipping. So a thing that a push moves into the area mid-move is no
+// longer carried, things only near the new position can be, and both
+// clipping and carrying go in the snapshot's block order.
+//
+static mobj_t **pothings = NULL;
+static size_t pothingsbase = 0;
+static size_t numpothings = 0;
+static size_t maxpothings = 0;
+
+static size_t Polyobj_gatherThings(polyobj_t *po)
+{
+	const size_t oldbase = pothingsbase;
+	fixed_t bbox[4];
+	INT32 xl, xh, yl, yh, x, y;
+	size_t i;
+
+	pothingsbase = numpothings;
+
+	if (!(po->flags & POF_SOLID))
+		return oldbase;
+
+	bbox[BOXLEFT]   = bbox[BOXRIGHT] = po->vertices[0]->x;
+	bbox[BOXBOTTOM] = bbox[BOXTOP]   = po->vertices[0]->y;
+	for (i = 1; i < po->numVertices; ++i)
+		M_AddToBox(bbox, po->vertices[i]->x, po->vertices[i]->y);
+
+	xl = (unsigned)(bbox[BOXLEFT]   - bmaporgx - MAXRADIUS) >> THINGBLOCKSHIFT;
+	xh = (unsigned)(bbox[BOXRIGHT]  - bmaporgx + MAXRADIUS) >> THINGBLOCKSHIFT;
+	yl = (unsigned)(bbox[BOXBOTTOM] - bmaporgy - MAXRADIUS) >> THINGBLOCKSHIFT;
+	yh = (unsigned)(bbox[BOXTOP]    - bmaporgy + MAXRADIUS) >> THINGBLOCKSHIFT;
+
+	BMBOUNDFIX(xl, xh, yl, yh);
+
+	if (xh >= thingmapwidth)
+		xh = thingmapwidth - 1;
+	if (yh >= thingmapheight)
+		yh = thingmapheight - 1;
+
+	for (y = yl; y <= yh; ++y)
+	{
+		for (x = xl; x <= xh; ++x)
+		{
+			mobj_t *mo;
+
+			for (mo = blocklinks[y * thingmapwidth + x]; mo; mo = mo->bnext)
+			{
+				if (numpothings == maxpothings)
+				{
+					maxpothings = maxpothings ? maxpothings*2 : 64;
+					pothings = Z_Realloc(pothings, maxpothings * sizeof (*pothings), PU_STATIC, NULL);
+				}
+				pothings[numpothings] = NULL;
+				P_SetTarget(&pothings[numpothings++], mo);
+			}
+		}
+	}
+
+	return oldbase;
+}
+
+//
+// Polyobj_releaseThings
+//
+// Drops the references taken by Polyobj_gatherThings.
+//
+static void Polyobj_releaseThings(size_t oldbase)
+{
+	while (numpothings > pothingsbase)
+		P_SetTarget(&pothings[--numpothings], NULL);
+	pothingsbase = oldbase;
+}
+
 //
 // Polyobj_carryThings
 //
@@ -1026,51 +1168,43 @@ static void Polyobj_slideThing(mobj_t *mo, fixed_t dx, fixed_t dy)
 static void Polyobj_carryThings(polyobj_t *po, fixed_t dx, fixed_t dy)
 {
 	static INT32 pomovecount = 0;
-	INT32 x, y;
+	size_t i;
 
 	pomovecount++;
 
 	if (!(po->flags & POF_SOLID))
 		return;
 
-	for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
+	for (i = pothingsbase; i < numpothings; ++i)
 	{
-		for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
-		{
-			mobj_t *mo;
-
-			if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
-				continue;
+		mobj_t *mo = pothings[i];
 
-			mo = blocklinks[y * bmapwidth + x];
+		if (P_MobjWasRemoved(mo))
+			continue;
 
-			for (; mo; mo = mo->bnext)
-			{
-				if (mo->lastlook == pomovecount)
-					continue;
+		if (mo->lastlook == pomovecount)
+			continue;
 
-				mo->lastlook = pomovecount;
+		mo->lastlook = pomovecount;
 
-				// Don't scroll objects that aren't affected by gravity
-				if (mo->flags & MF_NOGRAVITY)
-					continue;
-				// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
+		// Don't scroll objects that aren't affected by gravity
+		if (mo->flags & MF_NOGRAVITY)
+			continue;
+		// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
 
-				if (mo->flags & MF_NOCLIP)
-					continue;
+		if (mo->flags & MF_NOCLIP)
+			continue;
 
-				if ((mo->eflags & MFE_VERTICALFLIP) && mo->z + mo->height != po->lines[0]->backsector->floorheight)
-					continue;
+		if ((mo->eflags & MFE_VERTICALFLIP) && mo->z + mo->height != po->lines[0]->backsector->floorheight)
+			continue;
 
-				if (!(mo->eflags & MFE_VERTICALFLIP) && mo->z != po->lines[0]->backsector->ceilingheight)
-					continue;
+		if (!(mo->eflags & MFE_VERTICALFLIP) && mo->z != po->lines[0]->backsector->ceilingheight)
+			continue;
 
-				if (!P_MobjInsidePolyobj(po, mo))
-					continue;
+		if (!P_MobjInsidePolyobj(po, mo))
+			continue;
 
-				Polyobj_slideThing(mo, dx, dy);
-			}
-		}
+		Polyobj_slideThing(mo, dx, dy);
 	}
 }
 
@@ -1084,59 +1218,62 @@ static INT32 Polyobj_clipThings(polyobj_t *po, line_t *line)
 {
 	INT32 hitflags = 0;
 	fixed_t linebox[4];
-	INT32 x, y;
+	size_t i;
 
 	if (!(po->flags & POF_SOLID))
 		return hitflags;
 
-	// adjust linedef bounding box to blockmap, extend by MAXRADIUS
-	linebox[BOXLEFT]   = (unsigned)(line->bbox[BOXLEFT]   - bmaporgx - MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXRIGHT]  = (unsigned)(line->bbox[BOXRIGHT]  - bmaporgx + MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXBOTTOM] = (unsigned)(line->bbox[BOXBOTTOM] - bmaporgy - MAXRADIUS) >> MAPBLOCKSHIFT;
-	linebox[BOXTOP]    = (unsigned)(line->bbox[BOXTOP]    - bmaporgy + MAXRADIUS) >> MAPBLOCKSHIFT;
+	// adjust linedef bounding box to the thing blocks, extend by MAXRADIUS
+	linebox[BOXLEFT]   = (unsigned)(line->bbox[BOXLEFT]   - bmaporgx - MAXRADIUS) >> THINGBLOCKSHIFT;
+	linebox[BOXRIGHT]  = (unsigned)(line->bbox[BOXRIGHT]  - bmaporgx + MAXRADIUS) >> THINGBLOCKSHIFT;
+	linebox[BOXBOTTOM] = (unsigned)(line->bbox[BOXBOTTOM] - bmaporgy - MAXRADIUS) >> THINGBLOCKSHIFT;
+	linebox[BOXTOP]    = (unsigned)(line->bbox[BOXTOP]    - bmaporgy + MAXRADIUS) >> THINGBLOCKSHIFT;
 
-	// check all mobj blockmap cells the line contacts
-	for (y = linebox[BOXBOTTOM]; y <= linebox[BOXTOP]; ++y)
+	BMBOUNDFIX(linebox[BOXLEFT], linebox[BOXRIGHT], linebox[BOXBOTTOM], linebox[BOXTOP]);
+
+	// check all things in the mobj blockmap cells the line contacts
+	for (i = pothingsbase; i < numpothings; ++i)
 	{
-		for (x = linebox[BOXLEFT]; x <= linebox[BOXRIGHT]; ++x)
-		{
-			if (!(x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight))
-			{
-				mobj_t *mo = blocklinks[y * bmapwidth + x];
+		mobj_t *mo = pothings[i];
+		fixed_t x, y;
 
-				for (; mo; mo = mo->bnext)
-				{
+		if (P_MobjWasRemoved(mo) || !mo->bprev)
+			continue;
 
-					// Don't scroll objects that aren't affected by gravity
-					if (mo->flags & MF_NOGRAVITY)
-						continue;
-					// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
+		x = (unsigned)(mo->x - bmaporgx) >> THINGBLOCKSHIFT;
+		y = (unsigned)(mo->y - bmaporgy) >> THINGBLOCKSHIFT;
 
-					if (mo->flags & MF_NOCLIP)
-						continue;
+		if (x < linebox[BOXLEFT] || x > linebox[BOXRIGHT]
+			|| y < linebox[BOXBOTTOM] || y > linebox[BOXTOP])
+			continue;
 
-					if (mo->z + mo->height <= line->backsector->floorheight)
-						continue;
+		// Don't scroll objects that aren't affected by gravity
+		if (mo->flags & MF_NOGRAVITY)
+			continue;
+		// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
 
-					if (mo->z >= line->backsector->ceilingheight)
-						continue;
+		if (mo->flags & MF_NOCLIP)
+			continue;
 
-					if (Polyobj_untouched(line, mo))
-						continue;
+		if (mo->z + mo->height <= line->backsector->floorheight)
+			continue;
 
-					if (mo->flags & MF_PUSHABLE && (po->flags & POF_PUSHABLESTOP))
-						hitflags |= 2;
-					else
-						Polyobj_pushThing(po, line, mo);
+		if (mo->z >= line->backsector->ceilingheight)
+			continue;
 
-					if (mo->player && (po->lines[0]->backsector->flags & SF_TRIGGERSPECIAL_TOUCH) && !(po->flags & POF_NOSPECIALS))
-						P_ProcessSpecialSector(mo->player, mo->subsector->sector, po->lines[0]->backsector);
+		if (Polyobj_untouched(line, mo))
+			continue;
 
-					hitflags |= 1;
-				}
-			} // end if
-		} // end for (y)
-	} // end for (x)
+		if (mo->flags & MF_PUSHABLE && (po->flags & POF_PUSHABLESTOP))
+			hitflags |= 2;
+		else
+			Polyobj_pushThing(po, line, mo);
+
+		if (mo->player && (po->lines[0]->backsector->flags & SF_TRIGGERSPECIAL_TOUCH) && !(po->flags & POF_NOSPECIALS))
+			P_ProcessSpecialSector(mo->player, mo->subsector->sector, po->lines[0]->backsector);
+
+		hitflags |= 1;
+	}
 
 	return hitflags;
 }
@@ -1148,7 +1285,7 @@ static INT32 Polyobj_clipThings(polyobj_t *po, line_t *line)
 //
 static boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y)
 {
-	size_t i;
+	size_t i, thingsbase;
 	vertex_t vec;
 	INT32 hitflags = 0;
 
@@ -1159,6 +1296,8 @@ static boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y)
 	if (po->isBad)
 		return false;
 
+	P_InvalidateSightCache();
+
 	// translate vertices
 	for (i = 0; i < po->numVertices; ++i)
 		Polyobj_vecAdd(po->vertices[i], &vec);
@@ -1167,6 +1306,8 @@ static boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y)
 	for (i = 0; i < po->numLines; ++i)
 		Polyobj_bboxAdd(po->lines[i]->bbox, &vec);
 
+	thingsbase = Polyobj_gatherThings(po);
+
 	// check for blocking things (yes, it needs to be done separately)
 	for (i = 0; i < po->numLines; ++i)
 		hitflags |= Polyobj_clipThings(po, po->lines[i]);
@@ -1188,12 +1329,13 @@ static boolean Polyobj_moveXY(polyobj_t *po, fixed_t x, fixed_t y)
 		po->spawnSpot.y += vec.y;
 
 		Polyobj_carryThings(po, x, y);
-		Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
 		Polyobj_removeFromSubsec(po);   // unlink it from its subsector
-		Polyobj_linkToBlockmap(po);     // relink to blockmap
+		Polyobj_relinkBlockmap(po);     // relink to blockmap
 		Polyobj_attachToSubsec(po);     // relink to subsector
 	}
 
+	Polyobj_releaseThings(thingsbase);
+
 	return !(hitflags & 2);
 }
 
@@ -1269,7 +1411,7 @@ static void Polyobj_rotateLine(line_t *ld)
 static void Polyobj_rotateThings(polyobj_t *po, vertex_t origin, angle_t delta, UINT8 turnthings)
 {
 	static INT32 pomovecount = 10000;
-	INT32 x, y;
+	size_t i;
 	angle_t deltafine = delta >> ANGLETOFINESHIFT;
 
 	pomovecount++;
@@ -1277,73 +1419,65 @@ static void Polyobj_rotateThings(polyobj_t *po, vertex_t origin, angle_t delta,
 	if (!(po->flags & POF_SOLID))
 		return;
 
-	for (y = po->blockbox[BOXBOTTOM]; y <= po->blockbox[BOXTOP]; ++y)
+	for (i = pothingsbase; i < numpothings; ++i)
 	{
-		for (x = po->blockbox[BOXLEFT]; x <= po->blockbox[BOXRIGHT]; ++x)
-		{
-			mobj_t *mo;
-
-			if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight)
-				continue;
+		mobj_t *mo = pothings[i];
 
-			mo = blocklinks[y * bmapwidth + x];
+		if (P_MobjWasRemoved(mo))
+			continue;
 
-			for (; mo; mo = mo->bnext)
-			{
-				if (mo->lastlook == pomovecount)
-					continue;
+		if (mo->lastlook == pomovecount)
+			continue;
 
-				mo->lastlook = pomovecount;
+		mo->lastlook = pomovecount;
 
-				// Don't scroll objects that aren't affected by gravity
-				if (mo->flags & MF_NOGRAVITY)
-					continue;
-				// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
+		// Don't scroll objects that aren't affected by gravity
+		if (mo->flags & MF_NOGRAVITY)
+			continue;
+		// (The above check used to only move MF_SOLID objects, but that's inconsistent with conveyor behavior. -Red)
 
-				if (mo->flags & MF_NOCLIP)
-					continue;
+		if (mo->flags & MF_NOCLIP)
+			continue;
 
-				if ((mo->eflags & MFE_VERTICALFLIP) && mo->z + mo->height != po->lines[0]->backsector->floorheight)
-					continue;
+		if ((mo->eflags & MFE_VERTICALFLIP) && mo->z + mo->height != po->lines[0]->backsector->floorheight)
+			continue;
 
-				if (!(mo->eflags & MFE_VERTICALFLIP) && mo->z != po->lines[0]->backsector->ceilingheight)
-					continue;
+		if (!(mo->eflags & MFE_VERTICALFLIP) && mo->z != po->lines[0]->backsector->ceilingheight)
+			continue;
 
-				if (!P_MobjInsidePolyobj(po, mo))
-					continue;
+		if (!P_MobjInsidePolyobj(po, mo))
+			continue;
 
-				{
-					fixed_t oldxoff, oldyoff, newxoff, newyoff;
-					fixed_t c, s;
+		{
+			fixed_t oldxoff, oldyoff, newxoff, newyoff;
+			fixed_t c, s;
 
-					c = FINECOSINE(deltafine);
-					s = FINESINE(deltafine);
+			c = FINECOSINE(deltafine);
+			s = FINESINE(deltafine);
 
-					oldxoff = mo->x-origin.x;
-					oldyoff = mo->y-origin.y;
+			oldxoff = mo->x-origin.x;
+			oldyoff = mo->y-origin.y;
 
-					if (mo->player) // Hack to fix players sliding off of spinning polys -Red
-					{
-						fixed_t temp;
+			if (mo->player) // Hack to fix players sliding off of spinning polys -Red
+			{
+				fixed_t temp;
 
-						temp = FixedMul(oldxoff, c)-FixedMul(oldyoff, s);
-						oldyoff = FixedMul(oldyoff, c)+FixedMul(oldxoff, s);
-						oldxoff = temp;
-					}
+				temp = FixedMul(oldxoff, c)-FixedMul(oldyoff, s);
+				oldyoff = FixedMul(oldyoff, c)+FixedMul(oldxoff, s);
+				oldxoff = temp;
+			}
 
-					newxoff = FixedMul(oldxoff, c)-FixedMul(oldyoff, s);
-					newyoff = FixedMul(oldyoff, c)+FixedMul(oldxoff, s);
+			newxoff = FixedMul(oldxoff, c)-FixedMul(oldyoff, s);
+			newyoff = FixedMul(oldyoff, c)+FixedMul(oldxoff, s);
 
-					Polyobj_slideThing(mo, newxoff-oldxoff, newyoff-oldyoff);
+			Polyobj_slideThing(mo, newxoff-oldxoff, newyoff-oldyoff);
 
-					if (turnthings == 2 || (turnthings == 1 && !mo->player)) {
-						mo->angle += delta;
-						if (mo->player == &players[consoleplayer])
-							localangle = mo->angle;
-						else if (mo->player == &players[secondarydisplayplayer])
-							localangle2 = mo->angle;
-					}
-				}
+			if (turnthings == 2 || (turnthings == 1 && !mo->player)) {
+				mo->angle += delta;
+				if (mo->player == &players[consoleplayer])
+					localangle = mo->angle;
+				else if (mo->player == &players[secondarydisplayplayer])
+					localangle2 = mo->angle;
 			}
 		}
 	}
@@ -1356,7 +1490,7 @@ static void Polyobj_rotateThings(polyobj_t *po, vertex_t origin, angle_t delta,
 //
 static boolean Polyobj_rotate(polyobj_t *po, angle_t delta, UINT8 turnthings)
 {
-	size_t i;
+	size_t i, thingsbase;
 	angle_t angle;
 	vertex_t origin;
 	INT32 hitflags = 0;
@@ -1365,6 +1499,8 @@ static boolean Polyobj_rotate(polyobj_t *po, angle_t delta, UINT8 turnthings)
 	if (po->isBad)
 		return false;
 
+	P_InvalidateSightCache();
+
 	angle = (po->angle + delta) >> ANGLETOFINESHIFT;
 
 	// point about which to rotate is the spawn spot
@@ -1386,12 +1522,16 @@ static boolean Polyobj_rotate(polyobj_t *po, angle_t delta, UINT8 turnthings)
 	for (i = 0; i < po->numLines; ++i)
 		Polyobj_rotateLine(po->lines[i]);
 
+	thingsbase = Polyobj_gatherThings(po);
+
 	// check for blocking things
 	for (i = 0; i < po->numLines; ++i)
 		hitflags |= Polyobj_clipThings(po, po->lines[i]);
 
 	Polyobj_rotateThings(po, origin, delta, turnthings);
 
+	Polyobj_releaseThings(thingsbase);
+
 	if (hitflags & 2)
 	{
 		// reset vertices to previous positions
@@ -1411,9 +1551,8 @@ static boolean Polyobj_rotate(polyobj_t *po, angle_t delta, UINT8 turnthings)
 		// update polyobject's angle
 		po->angle += delta;
 
-		Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
 		Polyobj_removeFromSubsec(po);   // remove from subsector
-		Polyobj_linkToBlockmap(po);     // relink to blockmap
+		Polyobj_relinkBlockmap(po);     // relink to blockmap
 		Polyobj_attachToSubsec(po);     // relink to subsector
 	}
 
@@ -1503,7 +1642,7 @@ void Polyobj_InitLevel(void)
 
 	// run down the thinker list, count the number of spawn points, and save
 	// the mobj_t pointers on a queue for use below.
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function == (actionf_p1)P_MobjThinker)
 		{
@@ -1807,7 +1946,7 @@ void T_PolyObjWaypoint(polywaypoint_t *th)
 
 	// Find out target first.
 	// We redo this each tic to make savegame compatibility easier.
-	for (wp = thinkercap.next; wp != &thinkercap; wp = wp->next)
+	for (wp = thlist[THINK_MOBJ].cnext; wp != &thlist[THINK_MOBJ]; wp = wp->cnext)
 	{
 		if (wp->function != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 			continue;
@@ -1890,7 +2029,7 @@ void T_PolyObjWaypoint(polywaypoint_t *th)
 			CONS_Debug(DBG_POLYOBJ, "Looking for next waypoint...\n");
 
 			// Find next waypoint
-			for (wp = thinkercap.next; wp != &thinkercap; wp = wp->next)
+			for (wp = thlist[THINK_MOBJ].cnext; wp != &thlist[THINK_MOBJ]; wp = wp->cnext)
 			{
 				if (wp->function != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 					continue;
@@ -1929,7 +2068,7 @@ void T_PolyObjWaypoint(polywaypoint_t *th)
 					th->stophere = true;
 				}
 
-				for (wp = thinkercap.next; wp != &thinkercap; wp = wp->next)
+				for (wp = thlist[THINK_MOBJ].cnext; wp != &thlist[THINK_MOBJ]; wp = wp->cnext)
 				{
 					if (wp->function != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 						continue;
@@ -1966,7 +2105,7 @@ void T_PolyObjWaypoint(polywaypoint_t *th)
 				if (!th->continuous)
 					th->comeback = false;
 
-				for (wp = thinkercap.next; wp != &thinkercap; wp = wp->next)
+				for (wp = thlist[THINK_MOBJ].cnext; wp != &thlist[THINK_MOBJ]; wp = wp->cnext)
 				{
 					if (wp->function != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 						continue;
@@ -2486,7 +2625,7 @@ INT32 EV_DoPolyObjWaypoint(polywaypointdata_t *pwdata)
 	th->stophere = false;
 
 	// Find the first waypoint we need to use
-	for (wp = thinkercap.next; wp != &thinkercap; wp = wp->next)
+	for (wp = thlist[THINK_MOBJ].cnext; wp != &thlist[THINK_MOBJ]; wp = wp->cnext)
 	{
 		if (wp->function != (actionf_p1)P_MobjThinker) // Not a mobj thinker
 			continue;
@@ -2833,9 +2972,8 @@ void T_PolyObjFlag(polymove_t *th)
 	for (i = 0; i < po->numLines; i++)
 		Polyobj_rotateLine(po->lines[i]);
 
-	Polyobj_removeFromBlockmap(po); // unlink it from the blockmap
 	Polyobj_removeFromSubsec(po);   // unlink it from its subsector
-	Polyobj_linkToBlockmap(po);     // relink to blockmap
+	Polyobj_relinkBlockmap(po);     // relink to blockmap
 	Polyobj_attachToSubsec(po);     // relink to subsector
 }
 
@@ -86,6 +86,7 @@ typedef struct polyobj_s
 	fixed_t zdist;         // viewz distance for sorting
 	angle_t angle;         // for rotation
 	UINT8 attached;         // if true, is attached to a subsector
+	struct subsector_s *subsector; // the subsector it is attached to
 
 	fixed_t blockbox[4]; // bounding box for clipping
 	UINT8 linked;         // is linked to blockmap
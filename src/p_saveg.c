@@ -1251,6 +1251,7 @@ static void SaveMobjThinker(const thinker_t *th, const UINT8 type)
 		WRITEUINT16(save_p, mobj->standingslope->id);
 
 	WRITEUINT32(save_p, mobj->mobjnum);
+	WRITEUINT32(save_p, mobj->tseq);
 }
 
 //
@@ -1875,7 +1876,7 @@ mobj_t *P_FindNewPosition(UINT32 oldposition)
 	thinker_t *th;
 	mobj_t *mobj;
 
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -1925,6 +1926,7 @@ static void LoadMobjThinker(actionf_p1 thinker)
 	UINT16 diff2;
 	INT32 i;
 	fixed_t z, floorz, ceilingz;
+	UINT32 tseq;
 
 	diff = READUINT32(save_p);
 	if (diff & MD_MORE)
@@ -1948,13 +1950,13 @@ static void LoadMobjThinker(actionf_p1 thinker)
 			return;
 		}
 
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = P_AllocMobj();
 
 		mobj->spawnpoint = &mapthings[spawnpointnum];
 		mapthings[spawnpointnum].mobj = mobj;
 	}
 	else
-		mobj = Z_Calloc(sizeof (*mobj), PU_LEVEL, NULL);
+		mobj = P_AllocMobj();
 
 	// declare this as a valid mobj as soon as possible.
 	mobj->thinker.function = thinker;
@@ -2133,6 +2135,7 @@ static void LoadMobjThinker(actionf_p1 thinker)
 	P_SetThingPosition(mobj);
 
 	mobj->mobjnum = READUINT32(save_p);
+	tseq = READUINT32(save_p);
 
 	if (mobj->player)
 	{
@@ -2143,6 +2146,7 @@ static void LoadMobjThinker(actionf_p1 thinker)
 	}
 
 	P_AddThinker(&mobj->thinker);
+	mobj->tseq = tseq; // P_SortMobjTypeLists puts it back in place
 
 	mobj->info = (mobjinfo_t *)next; // temporarily, set when leave this function
 	R_AddMobjInterpolator(mobj);
@@ -2647,7 +2651,8 @@ static void P_NetUnArchiveThinkers(void)
 		else
 		{
 			R_DestroyLevelInterpolators(currentthinker);
-			Z_Free(currentthinker);
+			if (!currentthinker->cachable) // pooled mobjs awaiting removal go with PU_LEVEL
+				Z_Free(currentthinker);
 		}
 	}
 
@@ -2822,14 +2827,16 @@ static void P_NetUnArchiveThinkers(void)
 		}
 	}
 
+	P_SortMobjTypeLists();
+
 	CONS_Debug(DBG_NETPLAY, "%u thinkers loaded\n", numloaded);
 
 	if (restoreNum)
 	{
 		executor_t *delay = NULL;
 		UINT32 mobjnum;
-		for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
-			currentthinker = currentthinker->next)
+		for (currentthinker = thlist[THINK_MAIN].cnext; currentthinker != &thlist[THINK_MAIN];
+			currentthinker = currentthinker->cnext)
 		{
 			if (currentthinker->function == (actionf_p1)T_ExecutorDelay)
 			{
@@ -2942,8 +2949,8 @@ static inline void P_FinishMobjs(void)
 	mobj_t *mobj;
 
 	// put info field there real value
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
-		currentthinker = currentthinker->next)
+	for (currentthinker = thlist[THINK_MOBJ].cnext; currentthinker != &thlist[THINK_MOBJ];
+		currentthinker = currentthinker->cnext)
 	{
 		if (currentthinker->function == (actionf_p1)P_MobjThinker)
 		{
@@ -2960,8 +2967,8 @@ static void P_RelinkPointers(void)
 	UINT32 temp;
 
 	// use info field (value = oldposition) to relink mobjs
-	for (currentthinker = thinkercap.next; currentthinker != &thinkercap;
-		currentthinker = currentthinker->next)
+	for (currentthinker = thlist[THINK_MOBJ].cnext; currentthinker != &thlist[THINK_MOBJ];
+		currentthinker = currentthinker->cnext)
 	{
 		if (currentthinker->function == (actionf_p1)P_MobjThinker)
 		{
@@ -3328,7 +3335,7 @@ void P_SaveNetGame(void)
 	P_NetArchiveMisc();
 
 	// Assign the mobjnumber for pointer tracking
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function == (actionf_p1)P_MobjThinker)
 		{
@@ -119,6 +119,7 @@ INT32 *blockmaplump; // Big blockmap
 fixed_t bmaporgx, bmaporgy;
 // for thing chains
 mobj_t **blocklinks;
+INT32 thingmapwidth, thingmapheight;
 
 // REJECT
 // For fast sight rejection.
@@ -807,7 +808,7 @@ void P_ReloadRings(void)
 	mapthing_t *mt = mapthings;
 
 	// scan the thinkers to find rings/wings/hoops to unset
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -1686,6 +1687,14 @@ static boolean LineInBlock(fixed_t cx1, fixed_t cy1, fixed_t cx2, fixed_t cy2, f
 	return P_BoxOnLineSide(bbox, &testline) == -1;
 }
 
+// Allocates the (empty) thing chains for the current blockmap size.
+static void P_ClearThingBlocks(void)
+{
+	thingmapwidth = bmapwidth*THINGBLOCKS;
+	thingmapheight = bmapheight*THINGBLOCKS;
+	blocklinks = Z_Calloc(sizeof (*blocklinks) * thingmapwidth * thingmapheight, PU_LEVEL, NULL);
+}
+
 //
 // killough 10/98:
 //
@@ -1877,9 +1886,9 @@ static void P_CreateBlockMap(void)
 		}
 	}
 	{
-		size_t count = sizeof (*blocklinks) * bmapwidth * bmapheight;
+		size_t count;
 		// clear out mobj chains (copied from from P_LoadBlockMap)
-		blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+		P_ClearThingBlocks();
 		blockmap = blockmaplump + 4;
 
 
@@ -1954,8 +1963,7 @@ static boolean P_LoadBlockMap(lumpnum_t lumpnum)
 	bmapheight = blockmaplump[3];
 
 	// clear out mobj chains
-	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
-	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	P_ClearThingBlocks();
 	blockmap = blockmaplump+4;
 
 
@@ -2019,8 +2027,7 @@ static boolean P_LoadRawBlockMap(UINT8 *data, size_t count, const char *lumpname
 	bmapheight = blockmaplump[3];
 
 	// clear out mobj chains
-	count = sizeof (*blocklinks)* bmapwidth*bmapheight;
-	blocklinks = Z_Calloc(count, PU_LEVEL, NULL);
+	P_ClearThingBlocks();
 	blockmap = blockmaplump+4;
 
 	// haleyjd 2/22/06: setup polyobject blockmap
@@ -2126,6 +2133,31 @@ static void P_GroupLines(void)
 	}
 }
 
+//
+// P_RejectUsable
+//
+// A REJECT table is only worth consulting if it covers every sector pair
+// and actually rejects something. Most node builders write one full of
+// zeroes, which would just cost P_CheckSight a lookup for nothing.
+//
+static boolean P_RejectUsable(const UINT8 *data, size_t count, const char *func)
+{
+	size_t i;
+
+	if (count < (numsectors*numsectors + 7)/8)
+	{
+		CONS_Debug(DBG_SETUP, "%s: REJECT lump is too small for %s sectors, will not be used\n", func, sizeu1(numsectors));
+		return false;
+	}
+
+	for (i = 0; i < count; i++)
+		if (data[i])
+			return true;
+
+	CONS_Debug(DBG_SETUP, "%s: REJECT lump is empty, will not be used\n", func);
+	return false;
+}
+
 //
 // P_LoadReject
 //
@@ -2152,7 +2184,14 @@ static void P_LoadReject(lumpnum_t lumpnum)
 		CONS_Debug(DBG_SETUP, "P_LoadReject: REJECT lump has size 0, will not be loaded\n");
 	}
 	else
+	{
 		rejectmatrix = W_CacheLumpNum(lumpnum, PU_LEVEL);
+		if (!P_RejectUsable(rejectmatrix, count, "P_LoadReject"))
+		{
+			Z_ChangeTag(rejectmatrix, PU_CACHE);
+			rejectmatrix = NULL;
+		}
+	}
 }
 
 // PK3 version
@@ -2172,6 +2211,8 @@ static void P_LoadRawReject(UINT8 *data, size_t count, const char *lumpname)
 		rejectmatrix = NULL;
 		CONS_Debug(DBG_SETUP, "P_LoadRawReject: REJECT lump has size 0, will not be loaded\n");
 	}
+	else if (!P_RejectUsable(data, count, "P_LoadRawReject"))
+		rejectmatrix = NULL;
 	else
 	{
 		rejectmatrix = Z_Malloc(count, PU_LEVEL, NULL); // allocate memory for the reject matrix
@@ -2345,7 +2386,7 @@ void P_LoadThingsOnly(void)
 	mobj_t *mo;
 	thinker_t *think;
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	for (think = thlist[THINK_MOBJ].cnext; think != &thlist[THINK_MOBJ]; think = think->cnext)
 	{
 		if (think->function != (actionf_p1)P_MobjThinker)
 			continue; // not a mobj thinker
@@ -2818,7 +2859,9 @@ boolean P_SetupLevel(boolean skipprecip)
 	R_ClearLevelSplats();
 #endif
 
-	mobjcache = NULL;
+	P_InitMobjPool();
+	P_InitPrecipPool();
+	P_InvalidateSightCache();
     R_InitializeLevelInterpolators();
 	P_InitThinkers();
 	R_InitMobjInterpolators();
@@ -16,6 +16,7 @@
 #include "p_local.h"
 #include "r_main.h"
 #include "r_state.h"
+#include "m_perfstats.h"
 
 //
 // P_CheckSight
@@ -32,6 +33,55 @@ typedef struct {
 
 static INT32 sightcounts[2];
 
+//
+// Sight cache
+//
+// Remembers the result of the BSP walk for recent sight lines. Entries are
+// keyed on the exact trace (not just the subsectors involved), so a hit
+// gives exactly what the walk would have, and are only good for the
+// current sightcachegen. The generation moves on every tic, and whenever
+// something may have moved a sector's planes or a polyobject.
+//
+
+#define SIGHTCACHESIZE 1024 // must be a power of two
+
+typedef struct
+{
+	fixed_t x1, y1, z1;   // t1's position and eye height
+	fixed_t x2, y2, z2, h2;
+	UINT32 gen;
+	boolean result;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+static UINT32 sightcachegen = 1;
+
+//
+// P_InvalidateSightCache
+//
+// Throws away every cached sight line. Call this after changing anything
+// P_CrossBSPNode looks at: sector floor and ceiling heights, or polyobject
+// positions.
+//
+void P_InvalidateSightCache(void)
+{
+	if (++sightcachegen == 0)
+	{
+		// wrapped around, old entries could look current again
+		memset(sightcache, 0, sizeof (sightcache));
+		sightcachegen = 1;
+	}
+}
+
+static sightcache_t *P_SightCacheSlot(const los_t *los, size_t ss1, size_t ss2)
+{
+	UINT32 hash = (UINT32)(ss1*2654435761u) ^ (UINT32)(ss2*40503u);
+	hash ^= (UINT32)los->strace.x ^ ((UINT32)los->strace.y<<7) ^ ((UINT32)los->t2x<<13) ^ ((UINT32)los->t2y<<19);
+	hash ^= (UINT32)los->sightzstart ^ ((UINT32)los->bottomslope<<5);
+	hash ^= hash>>16;
+	return &sightcache[hash & (SIGHTCACHESIZE-1)];
+}
+
 //
 // P_DivlineSide
 //
@@ -272,6 +322,7 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
 	const sector_t *s1, *s2;
 	size_t pnum;
 	los_t los;
+	sightcache_t *slot;
 
 	// First check for trivial rejection.
 	if (!t1 || !t2)
@@ -306,6 +357,7 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
 	// An unobstructed LOS is possible.
 	// Now look from eyes of t1 to any part of t2.
 	sightcounts[1]++;
+	ps_sight_checks.value.i++;
 
 	validcount++;
 
@@ -377,6 +429,24 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2)
 		}
 	}
 
+	slot = P_SightCacheSlot(&los, t1->subsector - subsectors, t2->subsector - subsectors);
+	if (slot->gen == sightcachegen
+		&& slot->x1 == los.strace.x && slot->y1 == los.strace.y && slot->z1 == los.sightzstart
+		&& slot->x2 == los.t2x && slot->y2 == los.t2y && slot->z2 == t2->z && slot->h2 == t2->height)
+	{
+		ps_sight_cachehits.value.i++;
+		return slot->result;
+	}
+
+	slot->gen = sightcachegen;
+	slot->x1 = los.strace.x;
+	slot->y1 = los.strace.y;
+	slot->z1 = los.sightzstart;
+	slot->x2 = los.t2x;
+	slot->y2 = los.t2y;
+	slot->z2 = t2->z;
+	slot->h2 = t2->height;
+
 	// the head node is the last node output
-	return P_CrossBSPNode((INT32)numnodes - 1, &los);
+	return (slot->result = P_CrossBSPNode((INT32)numnodes - 1, &los));
 }
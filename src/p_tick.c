@@ -26,6 +26,7 @@
 #include "m_cheat.h"
 #include "r_main.h"
 #include "i_video.h" // rendermode
+#include "d_netcmd.h" // cv_perfstats
 
 tic_t leveltime;
 
@@ -40,11 +41,22 @@ tic_t leveltime;
 // Both the head and tail of the thinker list.
 thinker_t thinkercap;
 
+// Both the head and tail of each per-class thinker list.
+thinker_t thlist[NUM_THINKERLISTS];
+
+// Head of each per-type mobj list, and where to append to it.
+mobj_t *mobjtypelist[NUMMOBJTYPES];
+static mobj_t **mobjtypetail[NUMMOBJTYPES];
+
+// Sequence number for the next mobj to join a type list
+static UINT32 mobjtypeseq;
+
 void Command_Numthinkers_f(void)
 {
 	INT32 num;
 	INT32 count = 0;
 	actionf_p1 action;
+	thinker_t *cap = &thinkercap; // deleted thinkers can be of any class
 	thinker_t *think;
 
 	if (gamestate != GS_LEVEL)
@@ -73,6 +85,7 @@ void Command_Numthinkers_f(void)
 	{
 		case 1:
 			action = (actionf_p1)P_MobjThinker;
+			cap = &thlist[THINK_MOBJ];
 			CONS_Printf(M_GetText("Number of %s: "), "P_MobjThinker");
 			break;
 		/*case 2:
@@ -85,14 +98,17 @@ void Command_Numthinkers_f(void)
 			break;*/
 		case 2:
 			action = (actionf_p1)P_NullPrecipThinker;
+			cap = &thlist[THINK_PRECIP];
 			CONS_Printf(M_GetText("Number of %s: "), "P_NullPrecipThinker");
 			break;
 		case 3:
 			action = (actionf_p1)T_Friction;
+			cap = &thlist[THINK_MAIN];
 			CONS_Printf(M_GetText("Number of %s: "), "T_Friction");
 			break;
 		case 4:
 			action = (actionf_p1)T_Pusher;
+			cap = &thlist[THINK_MAIN];
 			CONS_Printf(M_GetText("Number of %s: "), "T_Pusher");
 			break;
 		case 5:
@@ -104,12 +120,17 @@ void Command_Numthinkers_f(void)
 			return;
 	}
 
-	for (think = thinkercap.next; think != &thinkercap; think = think->next)
+	if (cap == &thinkercap)
 	{
-		if (think->function != action)
-			continue;
-
-		count++;
+		for (think = thinkercap.next; think != &thinkercap; think = think->next)
+			if (think->function == action)
+				count++;
+	}
+	else
+	{
+		for (think = cap->cnext; think != cap; think = think->cnext)
+			if (think->function == action)
+				count++;
 	}
 
 	CONS_Printf("%d\n", count);
@@ -117,7 +138,7 @@ void Command_Numthinkers_f(void)
 
 void Command_CountMobjs_f(void)
 {
-	thinker_t *th;
+	mobj_t *mo;
 	mobjtype_t i;
 	INT32 count;
 
@@ -141,14 +162,9 @@ void Command_CountMobjs_f(void)
 
 			count = 0;
 
-			for (th = thinkercap.next; th != &thinkercap; th = th->next)
-			{
-				if (th->function != (actionf_p1)P_MobjThinker)
-					continue;
-
-				if (((mobj_t *)th)->type == i)
+			for (mo = mobjtypelist[i]; mo; mo = mo->tnext)
+				if (!P_MobjWasRemoved(mo))
 					count++;
-			}
 
 			CONS_Printf(M_GetText("There are %d objects of type %d currently in the level.\n"), count, i);
 		}
@@ -161,14 +177,9 @@ void Command_CountMobjs_f(void)
 	{
 		count = 0;
 
-		for (th = thinkercap.next; th != &thinkercap; th = th->next)
-		{
-			if (th->function != (actionf_p1)P_MobjThinker)
-				continue;
-
-			if (((mobj_t *)th)->type == i)
+		for (mo = mobjtypelist[i]; mo; mo = mo->tnext)
+			if (!P_MobjWasRemoved(mo))
 				count++;
-		}
 
 		if (count > 0) // Don't bother displaying if there are none of this type!
 			CONS_Printf(" * %d: %d\n", i, count);
@@ -180,7 +191,157 @@ void Command_CountMobjs_f(void)
 //
 void P_InitThinkers(void)
 {
+	size_t i;
 	thinkercap.prev = thinkercap.next = &thinkercap;
+	for (i = 0; i < NUM_THINKERLISTS; i++)
+		thlist[i].cprev = thlist[i].cnext = &thlist[i];
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		mobjtypelist[i] = NULL;
+		mobjtypetail[i] = &mobjtypelist[i];
+	}
+	mobjtypeseq = 0;
+}
+
+//
+// P_LinkMobjType
+// Appends a mobj to the list for its type, giving it the next sequence
+// number, so every list stays sorted by tseq.
+//
+static void P_LinkMobjType(mobj_t *mobj)
+{
+	mobj->tseq = mobjtypeseq++;
+	mobj->tnext = NULL;
+	mobj->tprev = mobjtypetail[mobj->type];
+	*mobj->tprev = mobj;
+	mobjtypetail[mobj->type] = &mobj->tnext;
+}
+
+static void P_UnlinkMobjType(mobj_t *mobj)
+{
+	if (!mobj->tprev)
+		return;
+	if ((*mobj->tprev = mobj->tnext) != NULL)
+		mobj->tnext->tprev = mobj->tprev;
+	else
+		mobjtypetail[mobj->type] = mobj->tprev;
+	mobj->tnext = NULL;
+	mobj->tprev = NULL;
+}
+
+//
+// P_SetMobjType
+// Changes the type of a mobj, moving it to the end of the list for its
+// new type.
+//
+void P_SetMobjType(mobj_t *mobj, mobjtype_t type)
+{
+	if (mobj->type == type)
+		return;
+	if (!mobj->tprev) // not thinking, so not in any list
+	{
+		mobj->type = type;
+		return;
+	}
+
+	P_UnlinkMobjType(mobj);
+	mobj->type = type;
+	P_LinkMobjType(mobj);
+}
+
+static int P_CompareMobjTypeSeq(const void *a, const void *b)
+{
+	const UINT32 seqa = (*(const mobj_t *const *)a)->tseq;
+	const UINT32 seqb = (*(const mobj_t *const *)b)->tseq;
+	return (seqa > seqb) - (seqa < seqb);
+}
+
+//
+// P_SortMobjTypeLists
+// Loading a netgame relinks every mobj in thinker order, but a mobj that
+// changed type sits later in its list than that. Once the saved sequence
+// numbers are back in tseq, this sorts each list by them, so that joining
+// players iterate the lists in the same order as everyone else.
+//
+void P_SortMobjTypeLists(void)
+{
+	mobj_t **sorted = NULL;
+	size_t count, size = 0;
+	size_t i, j;
+	mobj_t *mo;
+
+	mobjtypeseq = 0;
+
+	for (i = 0; i < NUMMOBJTYPES; i++)
+	{
+		count = 0;
+		for (mo = mobjtypelist[i]; mo; mo = mo->tnext)
+			count++;
+		if (!count)
+			continue;
+
+		if (count > size)
+		{
+			size = count;
+			sorted = Z_Realloc(sorted, size * sizeof *sorted, PU_STATIC, NULL);
+		}
+
+		count = 0;
+		for (mo = mobjtypelist[i]; mo; mo = mo->tnext)
+			sorted[count++] = mo;
+		qsort(sorted, count, sizeof *sorted, P_CompareMobjTypeSeq);
+
+		mobjtypetail[i] = &mobjtypelist[i];
+		for (j = 0; j < count; j++)
+		{
+			mo = sorted[j];
+			mo->tprev = mobjtypetail[i];
+			*mo->tprev = mo;
+			mobjtypetail[i] = &mo->tnext;
+			if (mo->tseq >= mobjtypeseq)
+				mobjtypeseq = mo->tseq + 1;
+		}
+		*mobjtypetail[i] = NULL;
+	}
+
+	if (sorted)
+		Z_Free(sorted);
+}
+
+//
+// P_LinkThinkerClass
+// Links a thinker into the list for its class, which is decided by the
+// function it has when added. Thinkers that only set their function
+// afterwards are all sector specials and land in THINK_MAIN, as they should.
+// Insert at the same end as in thinkercap so both lists agree on order.
+//
+void P_LinkThinkerClass(thinker_t *thinker, boolean front)
+{
+	thinker_t *cap;
+
+	if (thinker->function == (actionf_p1)P_MobjThinker)
+		cap = &thlist[THINK_MOBJ];
+	else if (thinker->function == (actionf_p1)P_NullPrecipThinker
+	 || thinker->function == (actionf_p1)P_RainThinker
+	 || thinker->function == (actionf_p1)P_SnowThinker)
+		cap = &thlist[THINK_PRECIP];
+	else
+		cap = &thlist[THINK_MAIN];
+
+	if (front)
+	{
+		cap->cnext->cprev = thinker;
+		thinker->cnext = cap->cnext;
+		thinker->cprev = cap;
+		cap->cnext = thinker;
+	}
+	else
+	{
+		cap->cprev->cnext = thinker;
+		thinker->cnext = cap;
+		thinker->cprev = cap->cprev;
+		cap->cprev = thinker;
+	}
 }
 
 //
@@ -193,10 +354,13 @@ void P_AddThinker(thinker_t *thinker)
 	thinker->next = &thinkercap;
 	thinker->prev = thinkercap.prev;
 	thinkercap.prev = thinker;
+	P_LinkThinkerClass(thinker, false);
 
 	thinker->references = 0;    // killough 11/98: init reference counter to 0
 
 	thinker->cachable = (thinker->function == (actionf_p1)P_MobjThinker);
+	if (thinker->cachable)
+		P_LinkMobjType((mobj_t *)thinker);
 }
 
 //
@@ -230,11 +394,17 @@ void P_RemoveThinkerDelayed(void *pthinker)
 			 * point it to thinker->prev, so the iterator will correctly move on to
 			 * thinker->prev->next = thinker->next */
 			(next->prev = currentthinker = thinker->prev)->next = next;
+
+			/* And from its class list, which nobody iterates destructively */
+			thinker->cnext->cprev = thinker->cprev;
+			thinker->cprev->cnext = thinker->cnext;
 		}
 		R_DestroyLevelInterpolators(thinker);
 
 		if (thinker->cachable == true)
 		{
+			P_UnlinkMobjType((mobj_t *)thinker);
+
 			// put cachable thinkers in the mobj cache, so we can avoid allocations
 			((mobj_t *)thinker)->hnext = mobjcache;
 			mobjcache = (mobj_t *)thinker;
@@ -285,6 +455,78 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 	return targ;
 }
 
+//
+// Mobj dormancy
+//
+// With mobjdormancy on, enemies, monitors, springs and scenery that are
+// further than mobjdormancydist from every viewpoint below skip P_MobjThinker
+// entirely. Only synced state goes into the decision (player and awayview
+// mobjs, skybox viewpoints and two netvars), so every node puts the same
+// objects to sleep on the same tic. Local cameras are deliberately ignored.
+//
+#define MAXDORMANCYVIEWS (2*MAXPLAYERS + 2)
+
+static INT32 dormviewx[MAXDORMANCYVIEWS], dormviewy[MAXDORMANCYVIEWS];
+static INT32 numdormviews;
+static INT32 dormdist;
+
+static inline void P_AddDormancyView(mobj_t *mo)
+{
+	if (!mo || P_MobjWasRemoved(mo))
+		return;
+	dormviewx[numdormviews] = mo->x>>FRACBITS;
+	dormviewy[numdormviews] = mo->y>>FRACBITS;
+	numdormviews++;
+}
+
+// Snapshot the viewpoints once per tic, before any thinker moves them.
+static void P_SetupDormancy(void)
+{
+	INT32 i;
+
+	numdormviews = 0;
+	if (!cv_mobjdormancy.value)
+		return;
+
+	dormdist = cv_mobjdormancydist.value;
+	for (i = 0; i < MAXPLAYERS; i++)
+	{
+		if (!playeringame[i])
+			continue;
+		P_AddDormancyView(players[i].mo);
+		if (players[i].awayviewtics)
+			P_AddDormancyView(players[i].awayviewmobj);
+	}
+	P_AddDormancyView(skyboxmo[0]);
+	P_AddDormancyView(skyboxmo[1]);
+}
+
+//
+// P_MobjIsDormant
+// Returns true if this mobj should skip thinking this tic.
+//
+boolean P_MobjIsDormant(mobj_t *mobj)
+{
+	INT32 i, x, y;
+
+	// No viewpoints means dormancy is off, or nobody is in the level yet;
+	// either way, let everything think.
+	if (!numdormviews)
+		return false;
+
+	if (mobj->player || !(mobj->flags & (MF_ENEMY|MF_MONITOR|MF_SPRING|MF_SCENERY))
+	|| (mobj->flags & (MF_BOSS|MF_MISSILE)))
+		return false;
+
+	x = mobj->x>>FRACBITS;
+	y = mobj->y>>FRACBITS;
+	for (i = 0; i < numdormviews; i++)
+		if (abs(x - dormviewx[i]) < dormdist && abs(y - dormviewy[i]) < dormdist)
+			return false;
+
+	return true;
+}
+
 //
 // P_RunThinkers
 //
@@ -309,10 +551,24 @@ if ((*mop = targ) != NULL) // Set new target and if non-NULL, increase its count
 //
 static inline void P_RunThinkers(void)
 {
+	const boolean timed = (cv_perfstats.value == 4);
+
+	P_SetupDormancy();
+	P_SetupIdleRings();
+
 	for (currentthinker = thinkercap.next; currentthinker != &thinkercap; currentthinker = currentthinker->next)
 	{
 		if (currentthinker->function)
-			currentthinker->function(currentthinker);
+		{
+			// Sector specials and polyobject movers can change what
+			// anything can see, mobjs only by going through P_CheckSector.
+			if (currentthinker->function != (actionf_p1)P_MobjThinker)
+				P_InvalidateSightCache();
+			if (timed)
+				PS_RunTimedThinker(currentthinker);
+			else
+				currentthinker->function(currentthinker);
+		}
 	}
 }
 
@@ -629,6 +885,12 @@ void P_Ticker(boolean run)
 
 		ps_lua_mobjhooks.value.i = 0;
 		ps_checkposition_calls.value.i = 0;
+		ps_dormant_mobjs.value.i = 0;
+		ps_thingpair_tests.value.i = 0;
+		ps_sight_checks.value.i = 0;
+		ps_sight_cachehits.value.i = 0;
+
+		P_InvalidateSightCache();
 
 		LUAh_PreThinkFrame();
 
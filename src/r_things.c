@@ -1599,13 +1599,13 @@ static void R_ProjectPrecipitationSprite(precipmobj_t *thing)
 	}
 
 	// okay, we can't return now except for vertical clipping... this is a hack, but weather isn't networked, so it should be ok
-	if (!(thing->precipflags & PCF_THUNK))
+	if (thing->thinktic != leveltime)
 	{
 		if (thing->precipflags & PCF_RAIN)
 			P_RainThinker(thing);
 		else
 			P_SnowThinker(thing);
-		thing->precipflags |= PCF_THUNK;
+		thing->thinktic = leveltime;
 	}
 
 
@@ -180,6 +180,7 @@ void SCR_Startup(void)
 	CV_RegisterVar(&cv_tpscounter);
 	CV_RegisterVar(&cv_fpssize);
 	CV_RegisterVar(&cv_constextsize);
+	CV_RegisterVar(&cv_hudlayers);
 
 	V_SetPalette(0);
 }
@@ -78,6 +78,7 @@
 #ifdef HWRENDER
 #include "../hardware/hw_main.h"
 #include "../hardware/hw_drv.h"
+#include "../hardware/hw_batching.h"
 // For dynamic referencing of HW rendering functions
 #include "hwsym_sdl.h"
 #include "ogl_sdl.h"
@@ -1245,6 +1246,8 @@ void I_FinishUpdate(void)
 #ifdef HWRENDER
 	else if (rendermode == render_opengl)
 	{
+		// wipes and the intro flip pages while the frame's 2D is still batched
+		HWR_Flush2DBatch();
 		OglSdlFinishUpdate(cv_vidwait.value);
 	}
 #endif
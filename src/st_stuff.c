@@ -1916,7 +1916,7 @@ static void ST_doItemFinderIconsAndSound(void)
 		return;
 
 	// Scan thinkers to find emblem mobj with these ids
-	for (th = thinkercap.next; th != &thinkercap; th = th->next)
+	for (th = thlist[THINK_MOBJ].cnext; th != &thlist[THINK_MOBJ]; th = th->cnext)
 	{
 		if (th->function != (actionf_p1)P_MobjThinker)
 			continue;
@@ -1950,6 +1950,21 @@ static void ST_doItemFinderIconsAndSound(void)
 // Draw the status bar overlay, customisable: the user chooses which
 // kind of information to overlay
 //
+// Score, time, rings and lives, drawn as a HUD layer for each view.
+static vlayer_t st_statuslayers[2];
+
+static void ST_drawStatusLayer(void)
+{
+	if (LUA_HudEnabled(hud_score))
+		ST_drawScore();
+	if (LUA_HudEnabled(hud_time))
+		ST_drawTime();
+	if (LUA_HudEnabled(hud_rings))
+		ST_drawRings();
+	if (G_GametypeUsesLives() && LUA_HudEnabled(hud_lives))
+		ST_drawLives();
+}
+
 static void ST_overlayDrawer(void)
 {
 	//hu_showscores = auto hide score/time/rings when tab rankings are shown
@@ -1958,16 +1973,7 @@ static void ST_overlayDrawer(void)
 		if (maptol & TOL_NIGHTS)
 			ST_drawNiGHTSHUD();
 		else
-		{
-			if (LUA_HudEnabled(hud_score))
-				ST_drawScore();
-			if (LUA_HudEnabled(hud_time))
-				ST_drawTime();
-			if (LUA_HudEnabled(hud_rings))
-				ST_drawRings();
-			if (G_GametypeUsesLives() && LUA_HudEnabled(hud_lives))
-				ST_drawLives();
-		}
+			V_DrawLayer(&st_statuslayers[splitscreen && stplyr == &players[secondarydisplayplayer]], ST_drawStatusLayer);
 	}
 
 	// GAME OVER pic
@@ -44,6 +44,7 @@ consvar_t cv_ticrate = { "showfps", "No", CV_SAVE, ticrate_cons_t, NULL, 0, NULL
 consvar_t cv_tpscounter = { "showtps", "No", CV_SAVE, tpscounter_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL };
 static CV_PossibleValue_t fpssize_cons_t[] = { {0, "Normal"}, {1, "Thin"}, {2, "Small"}, {0, NULL} };
 consvar_t cv_fpssize = { "fpssize", "Normal", CV_SAVE, fpssize_cons_t, NULL, 0, NULL, NULL, 0, 0, NULL };
+consvar_t cv_hudlayers = {"hudlayers", "On", CV_SAVE, CV_OnOff, NULL, 0, NULL, NULL, 0, 0, NULL};
 
 static void CV_palette_OnChange(void);
 
@@ -444,12 +445,51 @@ static void CV_constextsize_OnChange(void)
 }
 
 
+// --------------------------------------------------------------------------
+// HUD layer hashing, see V_DrawLayer
+// --------------------------------------------------------------------------
+
+// While a layer is being hashed, the drawing functions below fold
+// their arguments into v_layerhash instead of writing any pixels,
+// and note whether anything they would draw is translucent.
+static boolean v_layerhashing = false;
+static boolean v_layertranslucent = false;
+static UINT32 v_layerhash;
+
+#define LAYERHASH(x) v_layerhash = (v_layerhash ^ (UINT32)(x)) * 0x01000193 // FNV-1a
+
+static void V_LayerHashPointer(const void *ptr)
+{
+	size_t p = (size_t)ptr;
+	LAYERHASH(p);
+	LAYERHASH(p >> 16 >> 16);
+}
+
+static void V_LayerHashPatch(const patch_t *patch)
+{
+	// the pointer alone could be reused by another patch once it's purged
+	V_LayerHashPointer(patch);
+	LAYERHASH(SHORT(patch->width));
+	LAYERHASH(SHORT(patch->height));
+	LAYERHASH(SHORT(patch->leftoffset));
+	LAYERHASH(SHORT(patch->topoffset));
+}
+
 // --------------------------------------------------------------------------
 // Copy a rectangular area from one bitmap to another (8bpp)
 // --------------------------------------------------------------------------
 void VID_BlitLinearScreen(const UINT8 *srcptr, UINT8 *destptr, INT32 width, INT32 height, size_t srcrowbytes,
 	size_t destrowbytes)
 {
+	if (v_layerhashing)
+	{
+		LAYERHASH(0x424c4954); // 'BLIT'
+		V_LayerHashPointer(srcptr);
+		LAYERHASH(width);
+		LAYERHASH(height);
+		return;
+	}
+
 	if (srcrowbytes == destrowbytes)
 		M_Memcpy(destptr, srcptr, srcrowbytes * height);
 	else
@@ -528,6 +568,20 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 		if (alphalevel >= 10)
 			return; // invis
 	}
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(pscale);
+		LAYERHASH(scrn & ~V_ALPHAMASK);
+		LAYERHASH(alphalevel);
+		V_LayerHashPatch(patch);
+		V_LayerHashPointer(colormap);
+		if (alphalevel)
+			v_layertranslucent = true;
+		return;
+	}
+
 	if (alphalevel)
 	{
 		v_translevel = transtables + ((alphalevel-1)<<FF_TRANSSHIFT);
@@ -664,6 +718,60 @@ void V_DrawFixedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_t
 	deststart = desttop;
 	destend = desttop + pwidth;
 
+	if (!(scrn & V_FLIP))
+	{
+		// Draw the patch one span at a time instead of one screen column at a time:
+		// the screen columns that sample the same patch column are filled together,
+		// so every post is only walked once and each row is written contiguously.
+		fixed_t nextcol;
+		INT32 span, left, right, i;
+
+		for (col = 0; (col>>FRACBITS) < SHORT(patch->width); col = nextcol, offx += span, desttop += span)
+		{
+			INT32 topdelta, prevdelta = -1;
+
+			for (nextcol = col + colfrac, span = 1; (nextcol>>FRACBITS) == (col>>FRACBITS); nextcol += colfrac)
+				span++;
+
+			if (x+offx >= vid.width) // don't draw off the right of the screen (WRAP PREVENTION)
+				break;
+			// don't draw off the left of the screen (WRAP PREVENTION)
+			left = (x+offx < 0) ? -(x+offx) : 0;
+			right = (x+offx+span > vid.width) ? vid.width-(x+offx) : span;
+			if (left >= right)
+				continue;
+
+			column = (const column_t *)((const UINT8 *)(patch) + LONG(patch->columnofs[col>>FRACBITS]));
+
+			while (column->topdelta != 0xff)
+			{
+				topdelta = column->topdelta;
+				if (topdelta <= prevdelta)
+					topdelta += prevdelta;
+				prevdelta = topdelta;
+				source = (const UINT8 *)(column) + 3;
+				dest = desttop + left + FixedInt(FixedMul(topdelta<<FRACBITS,fdup))*vid.width;
+
+				for (ofs = 0; dest < deststop && (ofs>>FRACBITS) < column->length; ofs += rowfrac)
+				{
+					if (dest >= screens[scrn&V_PARAMMASK]) // don't draw off the top of the screen (CRASH PREVENTION)
+					{
+						if (v_translevel) // depends on what's already on the screen
+						{
+							for (i = 0; i < right-left; i++)
+								dest[i] = patchdrawfunc(&dest[i], source, ofs);
+						}
+						else
+							memset(dest, patchdrawfunc(dest, source, ofs), right-left);
+					}
+					dest += vid.width;
+				}
+				column = (const column_t *)((const UINT8 *)column + column->length + 4);
+			}
+		}
+		return;
+	}
+
 	for (col = 0; (col>>FRACBITS) < SHORT(patch->width); col += colfrac, ++offx, desttop++)
 	{
 		INT32 topdelta, prevdelta = -1;
@@ -727,6 +835,20 @@ void V_DrawCroppedPatch(fixed_t x, fixed_t y, fixed_t pscale, INT32 scrn, patch_
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(pscale);
+		LAYERHASH(scrn);
+		V_LayerHashPatch(patch);
+		LAYERHASH(sx);
+		LAYERHASH(sy);
+		LAYERHASH(w);
+		LAYERHASH(h);
+		return;
+	}
+
 	// only use one dup, to avoid stretching (har har)
 	dupx = dupy = (vid.dupx < vid.dupy ? vid.dupx : vid.dupy);
 	fdup = FixedMul(dupx<<FRACBITS, pscale);
@@ -850,6 +972,17 @@ void V_DrawBlock(INT32 x, INT32 y, INT32 scrn, INT32 width, INT32 height, const
 		I_Error("Bad V_DrawBlock");
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(scrn);
+		LAYERHASH(width);
+		LAYERHASH(height);
+		V_LayerHashPointer(src);
+		return;
+	}
+
 	dest = screens[scrn] + y*vid.width + x;
 	deststop = screens[scrn] + vid.rowbytes * vid.height;
 
@@ -883,6 +1016,16 @@ void V_DrawFill(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c)
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(w);
+		LAYERHASH(h);
+		LAYERHASH(c);
+		return;
+	}
+
 	if (!(c & V_NOSCALESTART))
 	{
 		INT32 dupx = vid.dupx, dupy = vid.dupy;
@@ -1003,6 +1146,18 @@ void V_DrawFillConsoleMap(INT32 x, INT32 y, INT32 w, INT32 h, INT32 c)
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(w);
+		LAYERHASH(h);
+		LAYERHASH(c);
+		V_LayerHashPointer(consolebgmap);
+		v_layertranslucent = true;
+		return;
+	}
+
 	if (!(c & V_NOSCALESTART))
 	{
 		INT32 dupx = vid.dupx, dupy = vid.dupy;
@@ -1106,6 +1261,16 @@ void V_DrawFlatFill(INT32 x, INT32 y, INT32 w, INT32 h, lumpnum_t flatnum)
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(x);
+		LAYERHASH(y);
+		LAYERHASH(w);
+		LAYERHASH(h);
+		LAYERHASH(flatnum);
+		return;
+	}
+
 	size = W_LumpLength(flatnum);
 
 	switch (size)
@@ -1215,6 +1380,13 @@ void V_DrawFadeScreen(void)
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(0x46414445); // 'FADE'
+		v_layertranslucent = true;
+		return;
+	}
+
 	// heavily simplified -- we don't need to know x or y
 	// position when we're doing a full screen fade
 	for (; buf < deststop; ++buf)
@@ -1235,6 +1407,14 @@ void V_DrawFadeConsBack(INT32 plines)
 	}
 #endif
 
+	if (v_layerhashing)
+	{
+		LAYERHASH(plines);
+		V_LayerHashPointer(consolebgmap);
+		v_layertranslucent = true;
+		return;
+	}
+
 	// heavily simplified -- we don't need to know x or y position,
 	// just the stop position
 	deststop = screens[0] + vid.rowbytes * min(plines, vid.height);
@@ -1242,6 +1422,135 @@ void V_DrawFadeConsBack(INT32 plines)
 		*buf = consolebgmap[*buf];
 }
 
+// --------------------------------------------------------------------------
+// Retained HUD layers
+// --------------------------------------------------------------------------
+
+static UINT8 *layerscratch = NULL; // second recording pass, shared by all layers
+static size_t layerscratchsize = 0;
+
+// Runs the drawer with screens[0] redirected to dest, prefilled with fill.
+static void V_RecordLayerPass(UINT8 *dest, UINT8 fill, void (*drawer)(void))
+{
+	UINT8 *realscreen = screens[0];
+
+	memset(dest, fill, vid.width * vid.height);
+	screens[0] = dest;
+	drawer();
+	screens[0] = realscreen;
+}
+
+// Draws the layer twice over two different fills. Pixels that came out
+// the same in both passes are the ones the drawer covered, and they are
+// stored as spans so that they can be copied back without a mask.
+// translucent is whether the hashing pass saw any translucent drawing.
+static void V_RecordLayer(vlayer_t *layer, void (*drawer)(void), boolean translucent)
+{
+	const size_t size = vid.width * vid.height;
+	size_t i, start;
+
+	if (layer->size != size)
+	{
+		if (layer->pixels)
+			Z_Free(layer->pixels);
+		layer->pixels = Z_Malloc(size, PU_STATIC, NULL);
+		layer->size = size;
+	}
+	if (layerscratchsize < size)
+	{
+		if (layerscratch)
+			Z_Free(layerscratch);
+		layerscratch = Z_Malloc(size, PU_STATIC, NULL);
+		layerscratchsize = size;
+	}
+
+	V_RecordLayerPass(layer->pixels, 0x00, drawer);
+	V_RecordLayerPass(layerscratch, 0xff, drawer);
+
+	layer->numspans = 0;
+	for (i = 0; i < size;)
+	{
+		if (layer->pixels[i] != layerscratch[i])
+		{
+			i++;
+			continue;
+		}
+
+		start = i;
+		while (i < size && layer->pixels[i] == layerscratch[i])
+			i++;
+
+		if (layer->numspans + 2 > layer->maxspans)
+		{
+			layer->maxspans = layer->maxspans ? layer->maxspans * 2 : 256;
+			layer->spans = Z_Realloc(layer->spans, layer->maxspans * sizeof (*layer->spans), PU_STATIC, NULL);
+		}
+		layer->spans[layer->numspans++] = (UINT32)start;
+		layer->spans[layer->numspans++] = (UINT32)(i - start);
+	}
+
+	// Translucent pixels drawn over nothing would blend with the fills and
+	// get lost, so such layers keep being drawn directly.
+	layer->live = (translucent && !(layer->numspans == 2 && layer->spans[1] == size));
+	layer->valid = true;
+}
+
+//
+// Draws a HUD layer in the software renderer. The drawer is first run
+// without writing any pixels, only to hash the draw calls it makes. If the
+// hash is the same as the one the layer was recorded with, the recorded
+// pixels are copied to the screen instead of drawing everything again.
+// A layer is only recorded once the same hash is seen on two frames in a
+// row, so layers that change every frame don't pay for the recording.
+//
+// The drawer must only draw with the V_ functions, and must not have
+// side effects, since it can be called up to three times in a frame.
+//
+void V_DrawLayer(vlayer_t *layer, void (*drawer)(void))
+{
+	UINT32 hash;
+	size_t i;
+
+	if (rendermode != render_soft || !cv_hudlayers.value || !screens[0])
+	{
+		drawer();
+		return;
+	}
+
+	v_layerhash = 0x811c9dc5;
+	LAYERHASH(vid.width);
+	LAYERHASH(vid.height);
+	v_layertranslucent = false;
+	v_layerhashing = true;
+	drawer();
+	v_layerhashing = false;
+	hash = v_layerhash;
+
+	if (!(layer->valid && layer->hash == hash))
+	{
+		if (layer->pending != hash)
+		{
+			// first time this content is seen, it may not last
+			layer->pending = hash;
+			layer->valid = false;
+			drawer();
+			return;
+		}
+
+		V_RecordLayer(layer, drawer, v_layertranslucent);
+		layer->hash = hash;
+	}
+
+	if (layer->live)
+	{
+		drawer();
+		return;
+	}
+
+	for (i = 0; i < layer->numspans; i += 2)
+		M_Memcpy(screens[0] + layer->spans[i], layer->pixels + layer->spans[i], layer->spans[i+1]);
+}
+
 // Gets string colormap, used for 0x80 color codes
 //
 UINT8 *V_GetStringColormap(INT32 colorflags)
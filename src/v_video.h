@@ -27,7 +27,7 @@
 
 extern UINT8 *screens[5];
 
-extern consvar_t cv_ticrate, cv_tpscounter, cv_fpssize, cv_allcaps, cv_constextsize, \
+extern consvar_t cv_ticrate, cv_tpscounter, cv_fpssize, cv_allcaps, cv_constextsize, cv_hudlayers, \
 cv_globalgamma, cv_globalsaturation, \
 cv_rhue, cv_yhue, cv_ghue, cv_chue, cv_bhue, cv_mhue,\
 cv_rgamma, cv_ygamma, cv_ggamma, cv_cgamma, cv_bgamma, cv_mgamma, \
@@ -245,6 +245,20 @@ void V_DoPostProcessor(INT32 view, postimg_t type, INT32 param);
 
 void V_DrawPatchFill(patch_t *pat);
 
+// HUD graphics cached by V_DrawLayer
+typedef struct
+{
+	UINT32 hash; // draw calls the pixels were recorded from
+	UINT32 pending; // draw calls seen on the last frame the layer changed
+	boolean valid, live;
+	UINT8 *pixels;
+	size_t size;
+	UINT32 *spans; // offset/length pairs of the pixels that were drawn
+	size_t numspans, maxspans;
+} vlayer_t;
+
+void V_DrawLayer(vlayer_t *layer, void (*drawer)(void));
+
 void VID_BlitLinearScreen(const UINT8 *srcptr, UINT8 *destptr, INT32 width, INT32 height, size_t srcrowbytes,
 	size_t destrowbytes);
 
@@ -159,20 +159,19 @@ static void Y_CalculateMatchWinners(void);
 static void Y_FollowIntermission(void);
 static void Y_UnloadData(void);
 
+static vlayer_t y_layer;
+
 //
-// Y_IntermissionDrawer
+// Y_DrawIntermission
 //
-// Called by D_Display. Nothing is modified here; all it does is draw.
+// Nothing is modified here; all it does is draw.
 // Neat concept, huh?
 //
-void Y_IntermissionDrawer(void)
+static void Y_DrawIntermission(void)
 {
 	// Bonus loops
 	INT32 i;
 
-	if (intertype == int_none || rendermode == render_none)
-		return;
-
 	if (!usebuffer)
 		V_DrawFill(0, 0, BASEVIDWIDTH, BASEVIDHEIGHT, 31);
 
@@ -630,6 +629,20 @@ void Y_IntermissionDrawer(void)
 		V_DrawCenteredString(BASEVIDWIDTH/2, BASEVIDHEIGHT/2, V_YELLOWMAP, M_GetText("Teams will be scrambled next round!"));
 }
 
+//
+// Y_IntermissionDrawer
+//
+// Called by D_Display. The intermission covers the whole screen and only
+// changes while the tally is counting, so it is drawn as a HUD layer.
+//
+void Y_IntermissionDrawer(void)
+{
+	if (intertype == int_none || rendermode == render_none)
+		return;
+
+	V_DrawLayer(&y_layer, Y_DrawIntermission);
+}
+
 //
 // Y_Ticker
 //
@@ -943,6 +956,11 @@ void Y_StartIntermission(void)
 
 	intertic = -1;
 
+	// The layer only hashes the screens[1] pointer, not the screenshot in
+	// it, so a new intermission must never replay the last one's pixels.
+	y_layer.valid = false;
+	y_layer.pending = 0;
+
 #ifdef PARANOIA
 	if (endtic != -1)
 		I_Error("endtic is dirty");
@@ -1801,6 +1819,8 @@ static void Y_AwardSpecialStageBonus(void)
 void Y_EndIntermission(void)
 {
 	Y_UnloadData();
+	y_layer.valid = false;
+	y_layer.pending = 0;
 
 	endtic = -1;
 	intertype = int_none;